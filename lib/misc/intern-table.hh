@@ -0,0 +1,125 @@
+/**
+ ** \file misc/intern-table.hh
+ ** \brief Declaration of misc::intern_table.
+ **
+ ** An interning table maps equal values to a single, immutable entry.
+ ** It is the engine behind misc::unique (and therefore misc::symbol).
+ **
+ ** The table is an open-addressing hash table (linear probing) whose
+ ** slots are atomic pointers to entries.  Entries carry their
+ ** precomputed hash and a stable id, and are stored in an arena of
+ ** geometrically growing blocks: they never move, so their addresses
+ ** can be used as identities.
+ **
+ ** Lookups and insertions do not take any lock: a slot goes only once
+ ** from empty to either an entry or the "moved" mark, using a
+ ** compare-and-swap.  When a table is half full, it is migrated to a
+ ** table twice as large: the migrating thread marks every empty slot as
+ ** moved, so that concurrent insertions are redirected to the new
+ ** table, and copies the existing entries.  Retired tables are kept
+ ** until the interning table dies, so readers never dereference freed
+ ** memory.
+ **/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace misc
+{
+  template <typename T, typename Hash = std::hash<T>,
+            typename Equal = std::equal_to<T>>
+  class intern_table
+  {
+  public:
+    /// An interned value.
+    struct entry
+    {
+      /// The value itself.
+      const T value;
+      /// The hash of \a value, computed once for all.
+      const std::size_t hash;
+      /// The position of this entry in the arena.
+      const std::size_t id;
+    };
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /** \name Ctor & Dtor.
+     ** \{ */
+    intern_table();
+    intern_table(const intern_table&) = delete;
+    intern_table& operator=(const intern_table&) = delete;
+    ~intern_table();
+    /** \} */
+
+    /// Return the unique entry equal to \a v, creating it if needed.
+    const entry& insert(const value_type& v);
+    /// Return the entry equal to \a v, or nullptr if there is none.
+    const entry* find(const value_type& v) const;
+
+    /// The number of interned values.
+    size_type size() const;
+
+  private:
+    /// Arena layout: block \a k holds `first_block_size << k' entries.
+    static constexpr size_type first_block_size = 256;
+    static constexpr size_type max_blocks = 48;
+    /// Initial number of slots of the hash table.
+    static constexpr size_type initial_capacity = 1024;
+
+    /// An open-addressing table, linked to its successor once it is
+    /// being migrated.
+    struct table
+    {
+      explicit table(size_type capacity);
+      ~table();
+
+      const size_type mask;
+      std::atomic<const entry*>* const slots;
+      /// Number of published entries, migrated ones included.
+      std::atomic<size_type> count{0};
+      /// Whether a thread has taken charge of the migration.
+      std::atomic<bool> migrating{false};
+      /// The table entries are migrated to.
+      std::atomic<table*> next{nullptr};
+      /// The table that was migrated to this one.
+      table* prev{nullptr};
+    };
+
+    /// Build an entry for \a v in the arena.
+    const entry& make_entry(const value_type& v, size_type hash);
+    /// The arena cell of id \a id.
+    entry* cell(size_type id) const;
+
+    /// Look for \a v in \a t and its successors.
+    const entry* find(const table* t, const value_type& v,
+                      size_type hash) const;
+    /// Insert \a v in \a t or its successors, using \a fresh (if
+    /// non-null) as the new entry.  Set \a fresh to null if it was
+    /// consumed.
+    const entry* insert(table* t, const value_type& v, size_type hash,
+                        const entry*& fresh);
+    /// Move the contents of \a t to a new table.
+    void migrate(table* t);
+
+    /// The sentinel marking migrated slots.
+    static const entry* moved();
+
+    std::atomic<table*> current_;
+    std::atomic<size_type> size_{0};
+
+    /// Arena of entries.
+    std::atomic<size_type> next_id_{0};
+    std::atomic<std::byte*> blocks_[max_blocks] = {};
+
+    Hash hasher_;
+    Equal equal_;
+  };
+
+} // namespace misc
+
+#include <misc/intern-table.hxx>
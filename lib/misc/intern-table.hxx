@@ -0,0 +1,251 @@
+/**
+ ** \file misc/intern-table.hxx
+ ** \brief Inline implementation of misc::intern_table.
+ */
+
+#pragma once
+
+#include <bit>
+#include <new>
+#include <thread>
+
+#include <misc/contract.hh>
+#include <misc/intern-table.hh>
+
+namespace misc
+{
+  /*--------.
+  | Table.  |
+  `--------*/
+
+  template <typename T, typename Hash, typename Equal>
+  intern_table<T, Hash, Equal>::table::table(size_type capacity)
+    : mask(capacity - 1)
+    , slots(new std::atomic<const entry*>[capacity]())
+  {
+    precondition(std::has_single_bit(capacity));
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  intern_table<T, Hash, Equal>::table::~table()
+  {
+    delete[] slots;
+  }
+
+  /*----------------.
+  | Ctor and dtor.  |
+  `----------------*/
+
+  template <typename T, typename Hash, typename Equal>
+  intern_table<T, Hash, Equal>::intern_table()
+    : current_(new table(initial_capacity))
+  {}
+
+  template <typename T, typename Hash, typename Equal>
+  intern_table<T, Hash, Equal>::~intern_table()
+  {
+    for (table* t = current_.load(); t != nullptr;)
+      {
+        table* prev = t->prev;
+        delete t;
+        t = prev;
+      }
+
+    const size_type n = next_id_.load();
+    for (size_type id = 0; id < n; ++id)
+      cell(id)->~entry();
+
+    for (size_type k = 0; k < max_blocks; ++k)
+      if (std::byte* block = blocks_[k].load())
+        ::operator delete(block, std::align_val_t(alignof(entry)));
+  }
+
+  /*--------.
+  | Arena.  |
+  `--------*/
+
+  template <typename T, typename Hash, typename Equal>
+  typename intern_table<T, Hash, Equal>::entry*
+  intern_table<T, Hash, Equal>::cell(size_type id) const
+  {
+    // Block k starts at id first_block_size * (2^k - 1).
+    const size_type k = std::bit_width(id / first_block_size + 1) - 1;
+    const size_type offset = id - first_block_size * ((size_type{1} << k) - 1);
+    std::byte* block = blocks_[k].load(std::memory_order_acquire);
+    return std::launder(reinterpret_cast<entry*>(block) + offset);
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry&
+  intern_table<T, Hash, Equal>::make_entry(const value_type& v,
+                                           size_type hash)
+  {
+    const size_type id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    const size_type k = std::bit_width(id / first_block_size + 1) - 1;
+    postcondition(k < max_blocks);
+
+    // Allocate the block if we are the first to need it.
+    if (!blocks_[k].load(std::memory_order_acquire))
+      {
+        const size_type bytes = (first_block_size << k) * sizeof(entry);
+        auto* block = static_cast<std::byte*>(
+          ::operator new(bytes, std::align_val_t(alignof(entry))));
+        std::byte* expected = nullptr;
+        if (!blocks_[k].compare_exchange_strong(expected, block,
+                                                std::memory_order_acq_rel))
+          ::operator delete(block, std::align_val_t(alignof(entry)));
+      }
+
+    const size_type offset = id - first_block_size * ((size_type{1} << k) - 1);
+    auto* place = blocks_[k].load(std::memory_order_acquire)
+      + offset * sizeof(entry);
+    return *new (place) entry{v, hash, id};
+  }
+
+  /*-----------------------.
+  | Lookup and insertion.  |
+  `-----------------------*/
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry*
+  intern_table<T, Hash, Equal>::moved()
+  {
+    alignas(entry) static const std::byte tag[sizeof(entry)] = {};
+    return reinterpret_cast<const entry*>(tag);
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry*
+  intern_table<T, Hash, Equal>::find(const table* t,
+                                     const value_type& v,
+                                     size_type hash) const
+  {
+    while (t)
+      {
+        size_type i = hash & t->mask;
+        for (size_type probes = 0; probes <= t->mask;
+             ++probes, i = (i + 1) & t->mask)
+          {
+            const entry* e = t->slots[i].load(std::memory_order_acquire);
+            // An empty slot ends the probe chain: the value was never
+            // inserted, neither here nor in a successor.
+            if (!e)
+              return nullptr;
+            if (e == moved())
+              break;
+            if (e->hash == hash && equal_(e->value, v))
+              return e;
+          }
+        t = t->next.load(std::memory_order_acquire);
+      }
+    return nullptr;
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry*
+  intern_table<T, Hash, Equal>::insert(table* t,
+                                       const value_type& v,
+                                       size_type hash,
+                                       const entry*& fresh)
+  {
+    // Entries given by the caller are migrated, not new ones.
+    const bool migrated = fresh != nullptr;
+    for (;;)
+      {
+        size_type i = hash & t->mask;
+        for (size_type probes = 0; probes <= t->mask;
+             ++probes, i = (i + 1) & t->mask)
+          {
+            const entry* e = t->slots[i].load(std::memory_order_acquire);
+            if (!e)
+              {
+                if (!fresh)
+                  fresh = &make_entry(v, hash);
+                if (t->slots[i].compare_exchange_strong(
+                      e, fresh, std::memory_order_acq_rel,
+                      std::memory_order_acquire))
+                  {
+                    const entry* res = fresh;
+                    fresh = nullptr;
+                    if (!migrated)
+                      size_.fetch_add(1, std::memory_order_relaxed);
+                    const size_type count =
+                      t->count.fetch_add(1, std::memory_order_relaxed) + 1;
+                    // Only the current table may start a migration: a
+                    // table being filled by a migration is not complete
+                    // yet.
+                    if (count > (t->mask + 1) / 2
+                        && t == current_.load(std::memory_order_acquire)
+                        && !t->migrating.exchange(true))
+                      migrate(t);
+                    return res;
+                  }
+                // Someone else filled the slot: E is its new content.
+              }
+            if (e == moved())
+              break;
+            if (e->hash == hash && equal_(e->value, v))
+              return e;
+          }
+
+        // The table is being migrated (or is full and about to be):
+        // continue in the successor.
+        table* next;
+        while (!(next = t->next.load(std::memory_order_acquire)))
+          std::this_thread::yield();
+        t = next;
+      }
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  void intern_table<T, Hash, Equal>::migrate(table* t)
+  {
+    auto* next = new table(2 * (t->mask + 1));
+    next->prev = t;
+    t->next.store(next, std::memory_order_release);
+
+    for (size_type i = 0; i <= t->mask; ++i)
+      {
+        // Close empty slots, copy the others.  A slot cannot change
+        // once it is not empty, so no entry is missed.
+        const entry* e = nullptr;
+        if (t->slots[i].compare_exchange_strong(e, moved(),
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_acquire))
+          continue;
+        insert(next, e->value, e->hash, e);
+      }
+
+    // Publish the new table only once it holds every entry of T, so
+    // that lookups starting there are complete.
+    current_.store(next, std::memory_order_release);
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry&
+  intern_table<T, Hash, Equal>::insert(const value_type& v)
+  {
+    const size_type hash = hasher_(v);
+    if (const entry* e =
+          find(current_.load(std::memory_order_acquire), v, hash))
+      return *e;
+
+    const entry* fresh = nullptr;
+    return *insert(current_.load(std::memory_order_acquire), v, hash, fresh);
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  const typename intern_table<T, Hash, Equal>::entry*
+  intern_table<T, Hash, Equal>::find(const value_type& v) const
+  {
+    return find(current_.load(std::memory_order_acquire), v, hasher_(v));
+  }
+
+  template <typename T, typename Hash, typename Equal>
+  typename intern_table<T, Hash, Equal>::size_type
+  intern_table<T, Hash, Equal>::size() const
+  {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+} // namespace misc
@@ -7,13 +7,23 @@
  ** dictionary is removed when the scope is closed.  Lookup of keys
  ** is done in the last added dictionnary first (LIFO).
  **
+ ** The stack is not materialized: a single hash map holds the visible
+ ** binding of each key, and an undo log records the bindings shadowed
+ ** (or introduced) by each put.  Opening a scope pushes a mark in the
+ ** log, closing it replays the log back to that mark.  Lookups are
+ ** therefore O(1), and opening and closing scopes O(1) amortized.
+ **
  ** In particular this class is used to implement symbol tables.
  **/
 
 #pragma once
 
-#include <map>
-#include <stack>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace misc
@@ -26,21 +36,39 @@ namespace misc
 
   template <typename Key, typename Data> class scoped_map
   {
-    // FIXED: Some code was deleted here.
+  public:
+    /// The type of the keys, without qualifiers.
+    using key_type = std::remove_const_t<Key>;
+    using mapped_type = Data;
 
   private:
-    std::stack<std::map<Key, Data>> stack{};
+    /// The visible bindings.
+    std::unordered_map<key_type, Data> map_;
+    /// An undo entry: a key, and the binding it had before the put,
+    /// if any.
+    using undo_type = std::pair<key_type, std::optional<Data>>;
+    /// The undo log.
+    std::vector<undo_type> log_;
+    /// The size of the undo log when each open scope began.
+    std::vector<std::size_t> scopes_;
 
   public:
     scoped_map();
     template <Is_pointer T> T get(Key key);
+    /// Return the data bound to \a key, throw std::invalid_argument if
+    /// it is unbound.
     Data get(Key key);
+    /// Return a pointer to the data bound to \a key, or nullptr if it
+    /// is unbound.  The pointer is valid until the next modification.
+    const Data* find(const key_type& key) const;
     void scope_begin();
     void scope_end();
     void put(Key val1, Data val2);
+
+    /// Print the visible bindings, and the depth of the scope stack.
+    std::ostream& dump(std::ostream& ostr) const;
   };
 
-  // FIXED: Some code was deleted here.
   template <typename Key, typename Data>
   std::ostream& operator<<(std::ostream& ostr,
                            const scoped_map<Key, Data>& tbl);
@@ -4,12 +4,10 @@
 
 #pragma once
 
-#include <sstream>
+#include <ostream>
 #include <stdexcept>
 #include <type_traits>
 
-#include <ranges>
-#include <stack>
 #include <misc/algorithm.hh>
 #include <misc/contract.hh>
 #include <misc/indent.hh>
@@ -17,86 +15,85 @@
 
 namespace misc
 {
-  // FIXED: Some code was deleted here.
-
   template <typename Key, typename Data>
   inline scoped_map<Key, Data>::scoped_map()
   {
-    std::map<Key, Data> first_scope{};
-    stack.push(first_scope);
+    // The outermost scope is always open.
+    scopes_.push_back(0);
   }
 
   template <typename Key, typename Data>
   template <Is_pointer T>
   inline T scoped_map<Key, Data>::get(Key key)
-
   {
-    if (stack.size() == 0)
-      {
-        throw std::invalid_argument("no scope begin");
-      }
-    auto map = stack.top();
-    stack.pop();
-    auto it = map.find(key);
-    if (it == map.end())
-      {
-        return nullptr;
-      }
-    stack.push(map);
-    return *it;
+    auto it = map_.find(key);
+    if (it == map_.end())
+      return nullptr;
+    return it->second;
   }
 
   template <typename Key, typename Data>
   inline Data scoped_map<Key, Data>::get(Key key)
   {
-    if (stack.size() == 0)
-      {
-        throw std::invalid_argument("no scope begin");
-      }
-    auto map = stack.top();
-    auto it = map.find(key);
-    if (it == map.end())
-      {
-        throw std::invalid_argument("invalid key");
-      }
-    return (*it).second;
+    auto it = map_.find(key);
+    if (it == map_.end())
+      throw std::invalid_argument("invalid key");
+    return it->second;
+  }
+
+  template <typename Key, typename Data>
+  inline const Data* scoped_map<Key, Data>::find(const key_type& key) const
+  {
+    auto it = map_.find(key);
+    return it == map_.end() ? nullptr : &it->second;
   }
 
   template <typename Key, typename Data>
   inline void scoped_map<Key, Data>::scope_begin()
   {
-    if (stack.size() == 0)
-      {
-        std::map<Key, Data> map{};
-        stack.push(map);
-        return;
-      }
-    std::map<Key, Data> map_ = stack.top();
-    std::map<Key, Data> map(map_);
-    stack.push(map);
+    scopes_.push_back(log_.size());
   }
 
   template <typename Key, typename Data>
   inline void scoped_map<Key, Data>::scope_end()
   {
-    if (stack.size() == 0)
+    if (scopes_.size() <= 1)
+      return;
+
+    const std::size_t mark = scopes_.back();
+    scopes_.pop_back();
+    // Undo the puts of the scope, the most recent first.
+    while (log_.size() > mark)
       {
-        return;
+        undo_type& undo = log_.back();
+        if (undo.second)
+          map_.insert_or_assign(std::move(undo.first), std::move(*undo.second));
+        else
+          map_.erase(undo.first);
+        log_.pop_back();
       }
-    stack.pop();
   }
 
   template <typename Key, typename Data>
   inline void scoped_map<Key, Data>::put(Key val1, Data val2)
   {
-    if (stack.size() == 0)
+    auto [it, inserted] = map_.try_emplace(val1, val2);
+    if (inserted)
+      log_.emplace_back(val1, std::nullopt);
+    else
       {
-        return;
+        log_.emplace_back(val1, std::move(it->second));
+        it->second = std::move(val2);
       }
-    auto map = stack.top();
-    stack.pop();
-    map[val1] = val2;
-    stack.push(map);
+  }
+
+  template <typename Key, typename Data>
+  inline std::ostream& scoped_map<Key, Data>::dump(std::ostream& ostr) const
+  {
+    ostr << "scoped_map (depth " << scopes_.size() << ")" << incendl;
+    for (const auto& [key, data] : map_)
+      ostr << key << " -> " << data << iendl;
+    return ostr << decendl;
   }
 
   template <typename Key, typename Data>
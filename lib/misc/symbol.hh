@@ -5,8 +5,8 @@
 
 #pragma once
 
+#include <functional>
 #include <iosfwd>
-#include <set>
 #include <string>
 
 #include <misc/unique.hh>
@@ -74,4 +74,10 @@ namespace misc
 
 } // namespace misc
 
+/// Hash a symbol on its interned id, not on its string.
+template <> struct std::hash<misc::symbol>
+{
+  std::size_t operator()(const misc::symbol& s) const noexcept;
+};
+
 #include <misc/symbol.hxx>
@@ -36,3 +36,9 @@ namespace misc
   }
 
 } // namespace misc
+
+inline std::size_t
+std::hash<misc::symbol>::operator()(const misc::symbol& s) const noexcept
+{
+  return s.id_get();
+}
@@ -0,0 +1,54 @@
+/**
+ ** Testing the interning table.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <misc/contract.hh>
+#include <misc/intern-table.hh>
+
+int main()
+{
+  using table_type = misc::intern_table<std::string>;
+
+  // Checking sequential interning, across several migrations.
+  {
+    table_type t;
+    const table_type::entry& toto = t.insert("toto");
+    assertion(&t.insert("toto") == &toto);
+    assertion(&t.insert("titi") != &toto);
+    assertion(t.find("tata") == nullptr);
+    assertion(t.size() == 2);
+
+    for (int i = 0; i < 10000; ++i)
+      t.insert("s" + std::to_string(i));
+    assertion(t.size() == 10002);
+    assertion(t.find("toto") == &toto);
+    assertion(toto.value == "toto");
+    assertion(toto.id == 0);
+  }
+
+  // Checking concurrent interning: every thread must get the same entry.
+  {
+    table_type t;
+    constexpr int nthreads = 4;
+    constexpr int nvalues = 20000;
+    std::vector<std::vector<const table_type::entry*>> seen(nthreads);
+    std::vector<std::thread> threads;
+    for (int n = 0; n < nthreads; ++n)
+      threads.emplace_back([&t, &seen, n] {
+        for (int i = 0; i < nvalues; ++i)
+          seen[n].push_back(&t.insert("v" + std::to_string(i)));
+      });
+    for (auto& thread : threads)
+      thread.join();
+
+    assertion(t.size() == nvalues);
+    for (int n = 1; n < nthreads; ++n)
+      assertion(seen[n] == seen[0]);
+    for (int i = 0; i < nvalues; ++i)
+      assertion(seen[0][i]->value == "v" + std::to_string(i));
+  }
+}
@@ -3,6 +3,7 @@
  */
 
 #include <ostream>
+#include <stdexcept>
 
 #include <misc/contract.hh>
 #include <misc/scoped-map.hh>
@@ -13,6 +14,7 @@ int main()
 
   const std::string toto1("toto");
   const std::string titi1("titi");
+  const std::string tata1("tata");
 
   // Checking symbol tables.
   misc::scoped_map<const std::string, int> t;
@@ -23,12 +25,27 @@ int main()
     {
       t.scope_begin();
       t.put(toto1, 1111);
-      assertion(t.get(toto1) == 1111);
+      t.put(toto1, 111);
+      t.put(tata1, 33);
+      assertion(t.get(toto1) == 111);
       assertion(t.get(titi1) == 22);
+      assertion(t.get(tata1) == 33);
       t.scope_end();
     }
     assertion(t.get(toto1) == 11);
     assertion(t.get(titi1) == 22);
+    bool unbound = false;
+    try
+      {
+        t.get(tata1);
+      }
+    catch (const std::invalid_argument&)
+      {
+        unbound = true;
+      }
+    assertion(unbound);
+    assertion(!t.find(tata1));
+    assertion(t.find(titi1) && *t.find(titi1) == 22);
     t.scope_end();
   }
 }
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <functional>
 #include <iosfwd>
-#include <set>
+
+#include <misc/intern-table.hh>
 
 namespace misc
 {
@@ -14,14 +16,19 @@ namespace misc
    **
    ** Implementation of the flyweight pattern.
    ** Map identical objects to a unique reference.
+   **
+   ** The objects are interned in a misc::intern_table, hence \a T must
+   ** be hashable with std::hash.  \a C is only used to order uniques.
    */
   template <typename T, class C = std::less<T>> class unique
   {
   protected:
     /// The unique's object type.
-    using object_set_type = std::set<T, C>;
+    using object_set_type = intern_table<T>;
     /// The type for the size of the unique set.
     using object_size_type = typename object_set_type::size_type;
+    /// The type of an interned object.
+    using object_entry_type = typename object_set_type::entry;
 
   public:
     using value_type = unique;
@@ -43,6 +50,8 @@ namespace misc
     /// The object referenced by \c this.
     const data_type& get() const;
     operator const data_type&() const;
+    /// The stable id of the object referenced by \c this.
+    std::size_t id_get() const;
 
     /// The number of referenced objects.
     static object_size_type object_map_size();
@@ -70,7 +79,7 @@ namespace misc
     static object_set_type& object_set_instance();
 
     /// Pointer to the unique referenced object.
-    const data_type* obj_;
+    const object_entry_type* obj_;
   };
 
   /** \brief Intercept output stream redirection.
@@ -13,23 +13,19 @@ namespace misc
   template <typename T, class C> unique<T, C>::unique(const data_type& s)
   // FIXED: Some code was deleted here (Initializations).
   /** \brief Following the Flyweight design pattern, set the attribute to a
-       unique reference of value s. You might want to check out std::set methods
-       on cppreference.com. */
+       unique reference of value s, interned in misc::intern_table. */
   /*
-   * This constructor adds the given object to the global set and initializes
-   * the obj_ attribute with the address of the corresponding set element.
+   * This constructor interns the given object in the global table and
+   * initializes the obj_ attribute with the address of its entry.
    */
-  {
-    auto& instance = object_set_instance();
-    instance.insert(s);
-
-    obj_ = &(*instance.find(s));
-  }
+    : obj_(&object_set_instance().insert(s))
+  {}
 
   template <typename T, class C>
   typename unique<T, C>::object_set_type& unique<T, C>::object_set_instance()
   // FIXED: Some code was deleted here (Classical Singleton pattern, a la Scott Meyers').
-  /** \brief Create a persistent instance of a set which would hold each value. */
+  /** \brief Create a persistent instance of a table which would hold each
+      value. */
   /*
    * Recall the singleton exercise from the C++ workshop: the instance is held
    * as a static member variable.
@@ -43,7 +39,7 @@ namespace misc
   typename unique<T, C>::object_size_type unique<T, C>::object_map_size()
   // FIXED: Some code was deleted here.
   /*
-   * This functions simply returns the size of the global set.
+   * This functions simply returns the size of the global table.
    */
   {
     auto& instance = object_set_instance();
@@ -57,7 +53,7 @@ namespace misc
    * This function simply returns the stored object.
    */
   {
-    return *obj_;
+    return obj_->value;
   }
 
   template <typename T, class C>
@@ -68,7 +64,13 @@ namespace misc
    * unique casted to a const reference to the data_type.
    */
   {
-    return *obj_;
+    return obj_->value;
+  }
+
+  template <typename T, class C>
+  inline std::size_t unique<T, C>::id_get() const
+  {
+    return obj_->id;
   }
 
   template <typename T, class C>
@@ -98,7 +100,7 @@ namespace misc
     C cmp;
     assertion(obj_);
     assertion(rhs.obj_);
-    return cmp(*obj_, *rhs.obj_);
+    return cmp(obj_->value, rhs.obj_->value);
   }
 
   template <typename T, class C>
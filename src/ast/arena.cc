@@ -0,0 +1,86 @@
+/**
+ ** \file ast/arena.cc
+ ** \brief Implementation of ast::Arena.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+#include <ast/arena.hh>
+
+namespace ast
+{
+  thread_local Arena* Arena::current_ = nullptr;
+  Arena::statistics_type Arena::statistics_;
+
+  Arena::Arena() { ++statistics_.arenas; }
+
+  Arena::~Arena()
+  {
+    for (std::byte* block : blocks_)
+      ::operator delete(block);
+  }
+
+  void Arena::close()
+  {
+    open_ = false;
+    if (live_ == 0)
+      delete this;
+  }
+
+  Arena::Scope::Scope(bool detached)
+    : previous_(current_)
+  {
+    if (!current_ || detached)
+      {
+        arena_ = new Arena;
+        current_ = arena_;
+      }
+  }
+
+  Arena::Scope::~Scope()
+  {
+    if (arena_)
+      {
+        current_ = previous_;
+        arena_->close();
+      }
+  }
+
+  std::ostream& Arena::statistics_dump(std::ostream& ostr)
+  {
+    auto line = [&ostr](const char* title, std::size_t n) -> std::ostream& {
+      return ostr << ' ' << std::setiosflags(std::ios::left) << std::setw(26)
+                  << title << std::resetiosflags(std::ios::left) << ": "
+                  << n;
+    };
+    ostr << "AST allocations\n";
+    line("arenas", statistics_.arenas) << '\n';
+    line("blocks", statistics_.blocks)
+      << " (" << statistics_.block_bytes << " bytes)\n";
+    line("nodes in arenas", statistics_.nodes)
+      << " (" << statistics_.node_bytes << " bytes)\n";
+    line("nodes on the heap", statistics_.heap_nodes) << '\n';
+    return ostr << '\n';
+  }
+
+  namespace
+  {
+    /// Where to report the statistics when exiting.
+    std::ostream* statistics_stream = nullptr;
+
+    void statistics_dump_at_exit()
+    {
+      Arena::statistics_dump(*statistics_stream);
+    }
+  } // namespace
+
+  void Arena::statistics_dump_on_exit(std::ostream& ostr)
+  {
+    if (!statistics_stream)
+      std::atexit(statistics_dump_at_exit);
+    statistics_stream = &ostr;
+  }
+
+} // namespace ast
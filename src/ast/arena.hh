@@ -0,0 +1,122 @@
+/**
+ ** \file ast/arena.hh
+ ** \brief Declaration of ast::Arena.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace ast
+{
+  /** \brief A region in which AST nodes are allocated.
+   **
+   ** ast::Ast overloads operator new and operator delete: while an
+   ** arena is current (see Arena::Scope), nodes are carved out of its
+   ** blocks by pointer bumping, whoever allocates them (the parser, the
+   ** tiger-factory helpers, astclone::Cloner and its subclasses...).
+   ** Otherwise they are allocated on the heap.
+   **
+   ** Deleting a node of an arena does not free anything: the arena
+   ** counts its live nodes, and once it is closed and its last node is
+   ** deleted, all its blocks are released at once.  There is therefore
+   ** one arena per generation of the program (one per parse, one per
+   ** cloning pass), freed when that generation is replaced.
+   **/
+  class Arena
+  {
+  public:
+    /// Allocation counters, cumulated over every arena.
+    struct statistics_type
+    {
+      /// Number of arenas opened.
+      std::size_t arenas = 0;
+      /// Number of blocks allocated, and their total size.
+      std::size_t blocks = 0;
+      std::size_t block_bytes = 0;
+      /// Number of nodes allocated in arenas, and their total size.
+      std::size_t nodes = 0;
+      std::size_t node_bytes = 0;
+      /// Number of nodes allocated outside of any arena.
+      std::size_t heap_nodes = 0;
+    };
+
+    /** \brief Make sure an arena is current during the lifetime of the
+     ** scope.
+     **
+     ** If no arena is current, open a new one, and close it when the
+     ** scope ends.  Otherwise, keep using the current one: a pass run
+     ** from another one (e.g., a parse of a Tweast while desugaring)
+     ** allocates in the generation being built.
+     **
+     ** A \a detached scope always opens a new arena, and restores the
+     ** current one when it ends: it is meant for trees that outlive
+     ** the generation in which they are built (e.g., the cached
+     ** prelude).
+     **/
+    class Scope
+    {
+    public:
+      explicit Scope(bool detached = false);
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+      ~Scope();
+
+    private:
+      /// The arena opened by this scope, if any.
+      Arena* arena_ = nullptr;
+      /// The arena that was current when this scope began.
+      Arena* previous_ = nullptr;
+    };
+
+    /// Allocate \a size bytes for a node, in the current arena if
+    /// there is one, otherwise on the heap.
+    static void* node_allocate(std::size_t size);
+    /// Release a node allocated by node_allocate.
+    static void node_deallocate(void* p);
+
+    /// The current arena, or nullptr.
+    static Arena* current();
+
+    /// The allocation counters.
+    static const statistics_type& statistics_get();
+    /// Report the allocation counters on \a ostr.
+    static std::ostream& statistics_dump(std::ostream& ostr);
+    /// Report the allocation counters on \a ostr when tc exits.
+    static void statistics_dump_on_exit(std::ostream& ostr);
+
+  private:
+    Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+
+    /// Return \a size bytes from the blocks of this arena.
+    void* allocate(std::size_t size);
+    /// Note that a node of this arena was deleted.
+    void release();
+    /// Note that no node will be allocated in this arena anymore.
+    void close();
+
+    /// The size of the usual blocks.
+    static constexpr std::size_t block_size = 64 * 1024;
+
+    /// The blocks, the last one being the one in use.
+    std::vector<std::byte*> blocks_;
+    /// The free space of the last block.
+    std::byte* next_ = nullptr;
+    std::byte* end_ = nullptr;
+    /// Number of nodes allocated here and not deleted yet.
+    std::size_t live_ = 0;
+    /// Whether the arena is still current.
+    bool open_ = true;
+
+    static thread_local Arena* current_;
+    static statistics_type statistics_;
+  };
+
+} // namespace ast
+
+#include <ast/arena.hxx>
@@ -0,0 +1,85 @@
+/**
+ ** \file ast/arena.hxx
+ ** \brief Inline methods of ast::Arena.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include <ast/arena.hh>
+
+namespace ast
+{
+  namespace detail
+  {
+    /// Prefix of every node, recording the arena it belongs to.
+    struct alignas(std::max_align_t) node_header
+    {
+      Arena* arena;
+    };
+  } // namespace detail
+
+  inline Arena* Arena::current() { return current_; }
+
+  inline const Arena::statistics_type& Arena::statistics_get()
+  {
+    return statistics_;
+  }
+
+  inline void* Arena::allocate(std::size_t size)
+  {
+    constexpr std::size_t align = alignof(std::max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+    if (static_cast<std::size_t>(end_ - next_) < size)
+      {
+        const std::size_t bytes = size > block_size ? size : block_size;
+        auto* block = static_cast<std::byte*>(::operator new(bytes));
+        blocks_.push_back(block);
+        next_ = block;
+        end_ = block + bytes;
+        ++statistics_.blocks;
+        statistics_.block_bytes += bytes;
+      }
+    void* res = next_;
+    next_ += size;
+    ++live_;
+    ++statistics_.nodes;
+    statistics_.node_bytes += size;
+    return res;
+  }
+
+  inline void* Arena::node_allocate(std::size_t size)
+  {
+    const std::size_t bytes = sizeof(detail::node_header) + size;
+    void* p = nullptr;
+    if (current_)
+      p = current_->allocate(bytes);
+    else
+      {
+        p = ::operator new(bytes);
+        ++statistics_.heap_nodes;
+      }
+    auto* header = new (p) detail::node_header{current_};
+    return header + 1;
+  }
+
+  inline void Arena::node_deallocate(void* p)
+  {
+    if (!p)
+      return;
+    auto* header = static_cast<detail::node_header*>(p) - 1;
+    if (Arena* arena = header->arena)
+      arena->release();
+    else
+      ::operator delete(header);
+  }
+
+  inline void Arena::release()
+  {
+    if (--live_ == 0 && !open_)
+      delete this;
+  }
+
+} // namespace ast
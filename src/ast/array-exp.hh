@@ -42,10 +42,14 @@ namespace ast
     const Exp& size_get() const;
     /// Return size of the array.
     Exp& size_get();
+    /// Set size of the array.
+    void size_set(Exp*);
     /// Return initial value assigned to all elements of the array.
     const Exp& init_get() const;
     /// Return initial value assigned to all elements of the array.
     Exp& init_get();
+    /// Set initial value assigned to all elements of the array.
+    void init_set(Exp*);
     /** \} */
 
   protected:
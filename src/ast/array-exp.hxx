@@ -15,8 +15,10 @@ namespace ast
 
   inline const Exp& ArrayExp::size_get() const { return *size_; }
   inline Exp& ArrayExp::size_get() { return *size_; }
+  inline void ArrayExp::size_set(Exp* size) { size_ = size; }
 
   inline const Exp& ArrayExp::init_get() const { return *init_; }
   inline Exp& ArrayExp::init_get() { return *init_; }
+  inline void ArrayExp::init_set(Exp* init) { init_ = init; }
 
 } // namespace ast
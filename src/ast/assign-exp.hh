@@ -38,10 +38,14 @@ namespace ast
     const Var& var_get() const;
     /// Return reference to the affected variable.
     Var& var_get();
+    /// Set the affected variable.
+    void var_set(Var*);
     /// Return assigned value.
     const Exp& exp_get() const;
     /// Return assigned value.
     Exp& exp_get();
+    /// Set assigned value.
+    void exp_set(Exp*);
     /** \} */
 
   protected:
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include <ast/arena.hh>
 #include <ast/fwd.hh>
 #include <ast/location.hh>
 
@@ -24,6 +27,12 @@ namespace ast
     virtual ~Ast() = default;
     /** \} */
 
+    /** \name Allocation in the current ast::Arena.
+     ** \{ */
+    static void* operator new(std::size_t size);
+    static void operator delete(void* p);
+    /** \} */
+
     /// \name Visitors entry point.
     /// \{ */
     /// Accept a const visitor \a v.
@@ -9,6 +9,13 @@
 
 namespace ast
 {
+  inline void* Ast::operator new(std::size_t size)
+  {
+    return Arena::node_allocate(size);
+  }
+
+  inline void Ast::operator delete(void* p) { Arena::node_deallocate(p); }
+
   inline const Location& Ast::location_get() const { return location_; }
   inline void Ast::location_set(const Location& location)
   {
@@ -46,6 +46,8 @@ namespace ast
     const Exp& exp_get() const;
     /// Return the cast expression.
     Exp& exp_get();
+    /// Set the cast expression.
+    void exp_set(Exp*);
     /// Return the target type.
     const Ty& ty_get() const;
     /// Return the target type.
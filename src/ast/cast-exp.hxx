@@ -12,6 +12,7 @@ namespace ast
 
   inline const Exp& CastExp::exp_get() const { return *exp_; }
   inline Exp& CastExp::exp_get() { return *exp_; }
+  inline void CastExp::exp_set(Exp* exp) { exp_ = exp; }
 
   inline const Ty& CastExp::ty_get() const { return *ty_; }
   inline Ty& CastExp::ty_get() { return *ty_; }
@@ -43,6 +43,8 @@ namespace ast
     const Exp& init_get() const;
     /// Return initial value of the field.
     Exp& init_get();
+    /// Set initial value of the field.
+    void init_set(Exp*);
     /** \} */
 
   protected:
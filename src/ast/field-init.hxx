@@ -15,5 +15,6 @@ namespace ast
 
   inline const Exp& FieldInit::init_get() const { return *init_; }
   inline Exp& FieldInit::init_get() { return *init_; }
+  inline void FieldInit::init_set(Exp* init) { init_ = init; }
 
 } // namespace ast
@@ -38,6 +38,8 @@ namespace ast
     const Var& var_get() const;
     /// Return the record that holds the field.
     Var& var_get();
+    /// Set the record that holds the field.
+    void var_set(Var*);
     /// Return the field's name.
     misc::symbol name_get() const;
     /// Set the field's name.
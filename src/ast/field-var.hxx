@@ -12,6 +12,7 @@ namespace ast
 
   inline const Var& FieldVar::var_get() const { return *var_; }
   inline Var& FieldVar::var_get() { return *var_; }
+  inline void FieldVar::var_set(Var* var) { var_ = var; }
 
   inline misc::symbol FieldVar::name_get() const { return name_; }
   inline void FieldVar::name_set(misc::symbol name) { name_ = name; }
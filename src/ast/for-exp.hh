@@ -38,14 +38,20 @@ namespace ast
     const VarDec& vardec_get() const;
     /// Return implicit variable declaration.
     VarDec& vardec_get();
+    /// Set implicit variable declaration.
+    void vardec_set(VarDec*);
     /// Return high bound of the loop.
     const Exp& hi_get() const;
     /// Return high bound of the loop.
     Exp& hi_get();
+    /// Set high bound of the loop.
+    void hi_set(Exp*);
     /// Return instructions executed in the loop.
     const Exp& body_get() const;
     /// Return instructions executed in the loop.
     Exp& body_get();
+    /// Set instructions executed in the loop.
+    void body_set(Exp*);
     /** \} */
 
   protected:
@@ -12,11 +12,14 @@ namespace ast
 
   inline const VarDec& ForExp::vardec_get() const { return *vardec_; }
   inline VarDec& ForExp::vardec_get() { return *vardec_; }
+  inline void ForExp::vardec_set(VarDec* vardec) { vardec_ = vardec; }
 
   inline const Exp& ForExp::hi_get() const { return *hi_; }
   inline Exp& ForExp::hi_get() { return *hi_; }
+  inline void ForExp::hi_set(Exp* hi) { hi_ = hi; }
 
   inline const Exp& ForExp::body_get() const { return *body_; }
   inline Exp& ForExp::body_get() { return *body_; }
+  inline void ForExp::body_set(Exp* body) { body_ = body; }
 
 } // namespace ast
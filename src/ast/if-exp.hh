@@ -49,14 +49,20 @@ namespace ast
     const Exp& test_get() const;
     /// Return condition.
     Exp& test_get();
+    /// Set condition.
+    void test_set(Exp*);
     /// Return instructions executed if condition is true.
     const Exp& thenclause_get() const;
     /// Return instructions executed if condition is true.
     Exp& thenclause_get();
+    /// Set instructions executed if condition is true.
+    void thenclause_set(Exp*);
     /// Return instructions executed if condition is false.
     const Exp& elseclause_get() const;
     /// Return instructions executed if condition is false.
     Exp& elseclause_get();
+    /// Set instructions executed if condition is false.
+    void elseclause_set(Exp*);
     /** \} */
 
   protected:
@@ -12,11 +12,20 @@ namespace ast
 
   inline const Exp& IfExp::test_get() const { return *test_; }
   inline Exp& IfExp::test_get() { return *test_; }
+  inline void IfExp::test_set(Exp* test) { test_ = test; }
 
   inline const Exp& IfExp::thenclause_get() const { return *thenclause_; }
   inline Exp& IfExp::thenclause_get() { return *thenclause_; }
+  inline void IfExp::thenclause_set(Exp* thenclause)
+  {
+    thenclause_ = thenclause;
+  }
 
   inline const Exp& IfExp::elseclause_get() const { return *elseclause_; }
   inline Exp& IfExp::elseclause_get() { return *elseclause_; }
+  inline void IfExp::elseclause_set(Exp* elseclause)
+  {
+    elseclause_ = elseclause;
+  }
 
 } // namespace ast
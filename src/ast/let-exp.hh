@@ -43,6 +43,8 @@ namespace ast
     const Exp& body_get() const;
     /// Return list of instructions.
     Exp& body_get();
+    /// Set list of instructions.
+    void body_set(Exp*);
     /** \} */
 
   protected:
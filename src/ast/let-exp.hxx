@@ -15,5 +15,6 @@ namespace ast
 
   inline const Exp& LetExp::body_get() const { return *body_; }
   inline Exp& LetExp::body_get() { return *body_; }
+  inline void LetExp::body_set(Exp* body) { body_ = body; }
 
 } // namespace ast
@@ -57,12 +57,16 @@ namespace ast
     const Exp& left_get() const;
     /// Return left operand.
     Exp& left_get();
+    /// Set left operand.
+    void left_set(Exp*);
     /// Return operator.
     OpExp::Oper oper_get() const;
     /// Return right operand.
     const Exp& right_get() const;
     /// Return right operand.
     Exp& right_get();
+    /// Set right operand.
+    void right_set(Exp*);
     /** \} */
 
   protected:
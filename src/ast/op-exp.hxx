@@ -12,10 +12,12 @@ namespace ast
 
   inline const Exp& OpExp::left_get() const { return *left_; }
   inline Exp& OpExp::left_get() { return *left_; }
+  inline void OpExp::left_set(Exp* left) { left_ = left; }
 
   inline OpExp::Oper OpExp::oper_get() const { return oper_; }
 
   inline const Exp& OpExp::right_get() const { return *right_; }
   inline Exp& OpExp::right_get() { return *right_; }
+  inline void OpExp::right_set(Exp* right) { right_ = right; }
 
 } // namespace ast
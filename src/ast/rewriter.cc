@@ -0,0 +1,116 @@
+/**
+ ** \file ast/rewriter.cc
+ ** \brief Implementation of ast::Rewriter.
+ */
+
+#include <ast/all.hh>
+#include <ast/rewriter.hh>
+
+namespace ast
+{
+  void Rewriter::operator()(FieldVar& e)
+  {
+    e.var_set(rewrite(e.var_get()));
+  }
+
+  void Rewriter::operator()(SubscriptVar& e)
+  {
+    e.var_set(rewrite(e.var_get()));
+    e.index_set(rewrite(e.index_get()));
+  }
+
+  void Rewriter::operator()(CallExp& e)
+  {
+    for (Exp*& arg : e.args_get())
+      arg = rewrite(*arg);
+  }
+
+  void Rewriter::operator()(OpExp& e)
+  {
+    e.left_set(rewrite(e.left_get()));
+    e.right_set(rewrite(e.right_get()));
+  }
+
+  void Rewriter::operator()(RecordExp& e)
+  {
+    e.type_name_get().accept(*this);
+    for (FieldInit* field : e.fields_get())
+      field->accept(*this);
+  }
+
+  void Rewriter::operator()(SeqExp& e)
+  {
+    for (Exp*& exp : e.exps_get())
+      exp = rewrite(*exp);
+  }
+
+  void Rewriter::operator()(AssignExp& e)
+  {
+    e.var_set(rewrite(e.var_get()));
+    e.exp_set(rewrite(e.exp_get()));
+  }
+
+  void Rewriter::operator()(IfExp& e)
+  {
+    e.test_set(rewrite(e.test_get()));
+    e.thenclause_set(rewrite(e.thenclause_get()));
+    e.elseclause_set(rewrite(e.elseclause_get()));
+  }
+
+  void Rewriter::operator()(WhileExp& e)
+  {
+    e.test_set(rewrite(e.test_get()));
+    e.body_set(rewrite(e.body_get()));
+  }
+
+  void Rewriter::operator()(ForExp& e)
+  {
+    e.vardec_get().accept(*this);
+    e.hi_set(rewrite(e.hi_get()));
+    e.body_set(rewrite(e.body_get()));
+  }
+
+  void Rewriter::operator()(LetExp& e)
+  {
+    e.chunks_get().accept(*this);
+    e.body_set(rewrite(e.body_get()));
+  }
+
+  void Rewriter::operator()(ArrayExp& e)
+  {
+    e.type_name_get().accept(*this);
+    e.size_set(rewrite(e.size_get()));
+    e.init_set(rewrite(e.init_get()));
+  }
+
+  void Rewriter::operator()(CastExp& e)
+  {
+    e.exp_set(rewrite(e.exp_get()));
+    e.ty_get().accept(*this);
+  }
+
+  void Rewriter::operator()(FieldInit& e)
+  {
+    e.init_set(rewrite(e.init_get()));
+  }
+
+  void Rewriter::operator()(VarDec& e)
+  {
+    // `type_name' might be omitted.
+    if (e.type_name_get())
+      e.type_name_get()->accept(*this);
+    // `init' can be null in case of formal parameter.
+    if (e.init_get())
+      e.init_set(rewrite(*e.init_get()));
+  }
+
+  void Rewriter::operator()(FunctionDec& e)
+  {
+    e.formals_get().accept(*this);
+    if (e.result_get())
+      e.result_get()->accept(*this);
+    if (e.body_get())
+      e.body_set(rewrite(*e.body_get()));
+  }
+
+} // namespace ast
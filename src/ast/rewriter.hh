@@ -0,0 +1,72 @@
+/**
+ ** \file ast/rewriter.hh
+ ** \brief Declaration of ast::Rewriter.
+ */
+
+#pragma once
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+
+namespace ast
+{
+  /** \brief Rewrite an AST in place (without support for objects).
+
+      A Rewriter walks the tree like ast::DefaultVisitor, but visits
+      every expression through rewrite(): a visit method may call
+      replace() to substitute another node for the one it visits,
+      and the parent is updated accordingly.  The replaced node is
+      then deleted, so the children it shares with its replacement
+      must be detached from it (using the \c *_set accessors) first.
+
+      Contrary to astclone::Cloner, the parts of the tree that are not
+      rewritten are neither copied nor invalidated: they keep their
+      bindings and their types.  Subclasses must bind and type the
+      nodes they synthesize themselves.  */
+  class Rewriter
+    : public DefaultVisitor
+    , public NonObjectVisitor
+  {
+  public:
+    /// Super class type.
+    using super_type = DefaultVisitor;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Visit \a e, and return the node it was rewritten into (\a e
+    /// itself if it was not replaced).
+    template <typename T> T* rewrite(T& e);
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(FieldVar& e) override;
+    void operator()(SubscriptVar& e) override;
+    void operator()(CallExp& e) override;
+    void operator()(OpExp& e) override;
+    void operator()(RecordExp& e) override;
+    void operator()(SeqExp& e) override;
+    void operator()(AssignExp& e) override;
+    void operator()(IfExp& e) override;
+    void operator()(WhileExp& e) override;
+    void operator()(ForExp& e) override;
+    void operator()(LetExp& e) override;
+    void operator()(ArrayExp& e) override;
+    void operator()(CastExp& e) override;
+    void operator()(FieldInit& e) override;
+    void operator()(VarDec& e) override;
+    void operator()(FunctionDec& e) override;
+    /// \}
+
+  protected:
+    /// Have the node being visited replaced by \a e.
+    void replace(Exp* e);
+
+  private:
+    /// The replacement requested by the last visit, if any.
+    Exp* replacement_ = nullptr;
+  };
+
+} // namespace ast
+
+#include <ast/rewriter.hxx>
@@ -0,0 +1,33 @@
+/**
+ ** \file ast/rewriter.hxx
+ ** \brief Template methods of ast::Rewriter.
+ */
+
+#pragma once
+
+#include <ast/exp.hh>
+#include <ast/rewriter.hh>
+#include <misc/contract.hh>
+
+namespace ast
+{
+  template <typename T> T* Rewriter::rewrite(T& e)
+  {
+    e.accept(*this);
+    Exp* res = replacement_;
+    if (!res)
+      return &e;
+    replacement_ = nullptr;
+    delete &e;
+    T* t = dynamic_cast<T*>(res);
+    postcondition(t);
+    return t;
+  }
+
+  inline void Rewriter::replace(Exp* e)
+  {
+    precondition(e && !replacement_);
+    replacement_ = e;
+  }
+
+} // namespace ast
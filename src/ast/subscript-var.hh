@@ -38,10 +38,14 @@ namespace ast
     const Var& var_get() const;
     /// Return the mother variable.
     Var& var_get();
+    /// Set the mother variable.
+    void var_set(Var*);
     /// Return the offset expression.
     const Exp& index_get() const;
     /// Return the offset expression.
     Exp& index_get();
+    /// Set the offset expression.
+    void index_set(Exp*);
     /** \} */
 
   protected:
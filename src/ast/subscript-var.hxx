@@ -12,8 +12,10 @@ namespace ast
 
   inline const Var& SubscriptVar::var_get() const { return *var_; }
   inline Var& SubscriptVar::var_get() { return *var_; }
+  inline void SubscriptVar::var_set(Var* var) { var_ = var; }
 
   inline const Exp& SubscriptVar::index_get() const { return *index_; }
   inline Exp& SubscriptVar::index_get() { return *index_; }
+  inline void SubscriptVar::index_set(Exp* index) { index_ = index; }
 
 } // namespace ast
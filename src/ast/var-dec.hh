@@ -49,6 +49,8 @@ namespace ast
     const Exp* init_get() const;
     /// Return the initial value (expression) assigned to the variable.
     Exp* init_get();
+    /// Set the initial value (expression) assigned to the variable.
+    void init_set(Exp*);
     /** \} */
 
     /// Return whether the variable is read-only or not.
@@ -37,10 +37,14 @@ namespace ast
     const Exp& test_get() const;
     /// Return exit condition of the loop.
     Exp& test_get();
+    /// Set exit condition of the loop.
+    void test_set(Exp*);
     /// Return instructions executed in the loop.
     const Exp& body_get() const;
     /// Return instructions executed in the loop.
     Exp& body_get();
+    /// Set instructions executed in the loop.
+    void body_set(Exp*);
     /** \} */
 
   protected:
@@ -12,8 +12,10 @@ namespace ast
 
   inline const Exp& WhileExp::test_get() const { return *test_; }
   inline Exp& WhileExp::test_get() { return *test_; }
+  inline void WhileExp::test_set(Exp* test) { test_ = test; }
 
   inline const Exp& WhileExp::body_get() const { return *body_; }
   inline Exp& WhileExp::body_get() { return *body_; }
+  inline void WhileExp::body_set(Exp* body) { body_ = body; }
 
 } // namespace ast
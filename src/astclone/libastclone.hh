@@ -12,7 +12,8 @@
 /// Cloning an ast::Ast.
 namespace astclone
 {
-  /** \brief Make a deep copy of an AST.
+  /** \brief Make a deep copy of an AST, in a new ast::Arena unless one
+   ** is current.
    ** \param tree abstract syntax tree's root.
    ** \return the cloned AST.  */
   template <typename T> T* clone(const T& tree);
@@ -25,7 +26,9 @@ namespace astclone
   template <typename A, typename B>
   using applicable_object = auto(const A&, const B&) -> A*;
 
-  /// Have the pure function \a f side effect on \a t.
+  /// Have the pure function \a f side effect on \a t.  The result of
+  /// \a f is built in a new ast::Arena (unless one is current), and the
+  /// previous tree is released.
   template <typename A> void apply(applicable<A> f, std::unique_ptr<A>& t1);
 
   template <typename A>
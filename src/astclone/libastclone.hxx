@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ast/arena.hh>
 #include <ast/exp.hh>
 #include <astclone/cloner.hh>
 #include <astclone/libastclone.hh>
@@ -9,6 +10,7 @@ namespace astclone
 {
   template <typename T> T* clone(const T& tree)
   {
+    ast::Arena::Scope arena;
     Cloner clone;
     clone(tree);
     return dynamic_cast<T*>(clone.result_get());
@@ -16,7 +18,11 @@ namespace astclone
 
   template <typename A> void apply(applicable<A> f, std::unique_ptr<A>& t1)
   {
-    A* t2 = f(*t1);
+    A* t2;
+    {
+      ast::Arena::Scope arena;
+      t2 = f(*t1);
+    }
     t1.reset(t2);
   }
 
@@ -26,14 +32,22 @@ namespace astclone
              bool cond_1,
              bool cond_2)
   {
-    A* t2 = f(*t1, cond_1, cond_2);
+    A* t2;
+    {
+      ast::Arena::Scope arena;
+      t2 = f(*t1, cond_1, cond_2);
+    }
     t1.reset(t2);
   }
 
   template <typename A, typename B>
   void apply(applicable_object<A, B> f, std::unique_ptr<A>& t1, B& t3)
   {
-    A* t2 = f(*t1, t3);
+    A* t2;
+    {
+      ast::Arena::Scope arena;
+      t2 = f(*t1, t3);
+    }
     t1.reset(t2);
   }
 
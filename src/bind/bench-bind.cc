@@ -0,0 +1,64 @@
+/**
+ ** \file bind/bench-bind.cc
+ ** \brief Measure the time taken to bind a large program.
+ **
+ ** Build with `make src/bind/bench-bind', run with an optional number
+ ** of declarations (100000 by default).
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ast/chunk-list.hh>
+#include <bind/libbind.hh>
+#include <misc/error.hh>
+#include <misc/timer.hh>
+#include <parse/libparse.hh>
+
+const char* program_name = "bench-bind";
+
+// A let with N variable, function and type declarations, each one
+// using the previous one: every header is a first declaration, and
+// every use a successful lookup.
+static std::string program(int n)
+{
+  std::ostringstream o;
+  o << "let\n"
+    << "  type t0 = int\n"
+    << "  function f0() : t0 = 0\n"
+    << "  var v0 : t0 := f0()\n";
+  for (int i = 1; i < n / 3; ++i)
+    o << "  type t" << i << " = t" << i - 1 << '\n'
+      << "  function f" << i << "() : t" << i << " = v" << i - 1 << '\n'
+      << "  var v" << i << " : t" << i << " := f" << i << "()\n";
+  o << "in\n"
+    << "  v0\n"
+    << "end\n";
+  return o.str();
+}
+
+int main(int argc, char* argv[])
+{
+  const int n = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const std::string input = program(n);
+
+  misc::timer t;
+  t.start();
+
+  t.push("parse");
+  ast::ChunkList* tree = parse::parse_unit(input);
+  t.pop("parse");
+
+  t.push("bind");
+  misc::error e = bind::bind(*tree);
+  t.pop("bind");
+
+  t.stop();
+
+  std::cout << n << " declarations\n";
+  t.dump(std::cout);
+  delete tree;
+  return e ? EXIT_FAILURE : EXIT_SUCCESS;
+}
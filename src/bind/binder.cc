@@ -5,14 +5,7 @@
 
 #include <ast/all.hh>
 #include <bind/binder.hh>
-#define GETFUN std::get<ast::FunctionDec*>(t)
-#define GETVAR std::get<ast::VarDec*>(t)
-#define GETTYPE std::get<ast::TypeDec*>(t)
-#define GET_LAST_CHUNK_FUN std::get<0>(std::get<chunk_tracker>(t))
-#define GET_LAST_CHUNK_VAR std::get<1>(std::get<chunk_tracker>(t))
-#define GET_LAST_CHUNK_TYPE std::get<2>(std::get<chunk_tracker>(t))
-
-#include <cstring>
+
 #include <misc/contract.hh>
 
 namespace bind
@@ -21,9 +14,6 @@ namespace bind
   | Error handling.  |
   `-----------------*/
 
-  // to show the number of scope
-  int nb_chunks = 0;
-
   /// The error handler.
   const misc::error& Binder::error_get() const { return error_; }
 
@@ -40,58 +30,13 @@ namespace bind
 
   template <> void Binder::visit_dec_header<ast::TypeDec>(ast::TypeDec& e)
   {
-    try
-      {
-        binding_tuples t = this->sm.get(e.name_get());
-        if (GETTYPE != nullptr && GET_LAST_CHUNK_TYPE == nb_chunks)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, redefinition of type "
-                         << e.name_get() << "\n"
-                         << GETTYPE->location_get() << ": first definition"
-                         << "\n";
-          }
-        else
-          {
-            sm.put(e.name_get(),
-                   {GETFUN,
-                    GETVAR,
-                    &e,
-                    {GET_LAST_CHUNK_FUN, GET_LAST_CHUNK_VAR, nb_chunks}});
-          }
-      }
-    catch (std::invalid_argument& er)
-      {
-        this->sm.put(e.name_get(), {nullptr, nullptr, &e, {0, 0, nb_chunks}});
-      }
+    dec_bind(e, "type");
   }
 
   template <>
   void Binder::visit_dec_header<ast::FunctionDec>(ast::FunctionDec& e)
   {
-    try
-      {
-        binding_tuples t = this->sm.get(e.name_get());
-        if (GETFUN != nullptr && GET_LAST_CHUNK_FUN == nb_chunks)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, redefinition of function "
-                         << e.name_get() << "\n"
-                         << GETFUN->location_get() << ": first definition\n";
-          }
-        else
-          {
-            sm.put(e.name_get(),
-                   {&e,
-                    GETVAR,
-                    GETTYPE,
-                    {nb_chunks, GET_LAST_CHUNK_VAR, GET_LAST_CHUNK_TYPE}});
-          }
-      }
-    catch (std::invalid_argument& er)
-      {
-        this->sm.put(e.name_get(), {&e, nullptr, nullptr, {nb_chunks, 0, 0}});
-      }
+    dec_bind(e, "function");
   }
 
   /*
@@ -110,7 +55,7 @@ namespace bind
 
   template <> void Binder::visit_dec_body<ast::FunctionDec>(ast::FunctionDec& e)
   {
-    this->sm.scope_begin();   // open the scope
+    scope_begin();            // open the scope
     (*this)(e.formals_get()); // visit
 
     if (e.result_get() != nullptr)
@@ -122,7 +67,7 @@ namespace bind
       {
         (*this)(*e.body_get()); // visit
       }
-    this->sm.scope_end(); // close the scope
+    scope_end(); // close the scope
   }
 
   /*
@@ -147,19 +92,19 @@ namespace bind
   void Binder::operator()(ast::FunctionChunk& e)
   {
     chunk_visit<ast::FunctionDec>(e);
-    nb_chunks++;
+    nb_chunks_++;
   }
 
   void Binder::operator()(ast::TypeChunk& e)
   {
     chunk_visit<ast::TypeDec>(e);
-    nb_chunks++;
+    nb_chunks_++;
   }
 
   void Binder::operator()(ast::VarChunk& e)
   {
     super_type::chunk_visit<ast::VarChunk>(e);
-    nb_chunks++;
+    nb_chunks_++;
   }
 
   /*
@@ -179,30 +124,7 @@ namespace bind
       {
         (*this)(e.init_get());
       }
-    try
-      {
-        binding_tuples t = this->sm.get(e.name_get());
-        if (GETVAR != nullptr && GET_LAST_CHUNK_VAR == nb_chunks)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, redefinition of variable "
-                         << e.name_get() << "\n"
-                         << GETVAR->location_get() << ": first definition"
-                         << "\n";
-          }
-        else
-          {
-            sm.put(e.name_get(),
-                   {GETFUN,
-                    &e,
-                    GETTYPE,
-                    {GET_LAST_CHUNK_FUN, nb_chunks, GET_LAST_CHUNK_TYPE}});
-          }
-      }
-    catch (std::invalid_argument& er)
-      {
-        this->sm.put(e.name_get(), {nullptr, &e, nullptr, {0, nb_chunks, 0}});
-      }
+    dec_bind(e, "variable");
 
     if (e.type_name_get() != nullptr)
       {
@@ -220,12 +142,12 @@ namespace bind
   void Binder::operator()(ast::ForExp& e)
   {
     (*this)(e.hi_get());
-    this->sm.scope_begin();
+    scope_begin();
     (*this)(e.vardec_get());
     break_stack.push(&e);
     (*this)(e.body_get());
     break_stack.pop();
-    this->sm.scope_end();
+    scope_end();
   }
 
   void Binder::operator()(ast::WhileExp& e)
@@ -238,77 +160,52 @@ namespace bind
 
   void Binder::operator()(ast::SimpleVar& e)
   {
-    try
-      {
-        auto t = this->sm.get(e.name_get());
-        ast::VarDec* def = GETVAR;
-        if (def == nullptr)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, undeclared variable " << e.name_get()
-                         << "\n";
-          }
-        e.def_set(def);
-      }
-    catch (std::invalid_argument& ex)
+    const binding<ast::VarDec>* b = vars_.find(e.name_get());
+    ast::VarDec* def = b ? b->def : nullptr;
+    if (def == nullptr)
       {
         this->error_ << misc::error::error_type::bind << e.location_get()
                      << ": bind error, undeclared variable " << e.name_get()
                      << "\n";
+        return;
       }
+    e.def_set(def);
   }
 
   void Binder::operator()(ast::CallExp& e)
   {
-    try
-      {
-        auto t = this->sm.get(e.name_get());
-        ast::FunctionDec* def = GETFUN;
-        if (def == nullptr)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, no fun " << e.name_get() << " T T\n";
-          }
-        std::vector<ast::Exp*> args = e.args_get();
-        for (auto it = args.begin(); it != args.end(); it++)
-          {
-            (*this)(*it);
-          }
-        e.def_set(def);
-      }
-    catch (std::invalid_argument& ex)
+    const binding<ast::FunctionDec>* b = funs_.find(e.name_get());
+    ast::FunctionDec* def = b ? b->def : nullptr;
+    if (def == nullptr)
       {
         this->error_ << misc::error::error_type::bind << e.location_get()
                      << ": bind error, no fun " << e.name_get() << " T T\n";
+        return;
       }
+    for (ast::Exp* arg : e.args_get())
+      {
+        (*this)(arg);
+      }
+    e.def_set(def);
   }
 
   void Binder::operator()(ast::RecordExp& e)
   {
-    try
-      {
-        auto t = this->sm.get(e.type_name_get().name_get());
-        ast::TypeDec* def = GETTYPE;
-        if (def == nullptr)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, undeclared type "
-                         << e.type_name_get().name_get() << "\n";
-          }
-        ast::NameTy* nt = &(e.type_name_get());
-        nt->def_set(def);
-        (*this)(nt);
-        std::vector<ast::FieldInit*> fields = e.fields_get();
-        for (auto it = fields.begin(); it != fields.end(); it++)
-          {
-            (*this)(*it);
-          }
-      }
-    catch (std::invalid_argument& er)
+    const binding<ast::TypeDec>* b = types_.find(e.type_name_get().name_get());
+    ast::TypeDec* def = b ? b->def : nullptr;
+    if (def == nullptr)
       {
         this->error_ << misc::error::error_type::bind << e.location_get()
                      << ": bind error, undeclared type "
                      << e.type_name_get().name_get() << "\n";
+        return;
+      }
+    ast::NameTy* nt = &(e.type_name_get());
+    nt->def_set(def);
+    (*this)(nt);
+    for (ast::FieldInit* field : e.fields_get())
+      {
+        (*this)(field);
       }
   }
 
@@ -319,26 +216,16 @@ namespace bind
         return;
       }
 
-    try
-      {
-        auto t = this->sm.get(e.name_get());
-
-        ast::TypeDec* def = GETTYPE;
-        if (def == nullptr)
-          {
-            this->error_ << misc::error::error_type::bind << e.location_get()
-                         << ": bind error, undeclared type " << e.name_get()
-                         << "\n";
-          }
-
-        e.def_set(def);
-      }
-    catch (std::invalid_argument& er)
+    const binding<ast::TypeDec>* b = types_.find(e.name_get());
+    ast::TypeDec* def = b ? b->def : nullptr;
+    if (def == nullptr)
       {
         this->error_ << misc::error::error_type::bind << e.location_get()
                      << ": bind error, undeclared type " << e.name_get()
                      << "\n";
       }
+
+    e.def_set(def);
   }
 
   void Binder::operator()(ast::BreakExp& e)
@@ -355,7 +242,7 @@ namespace bind
 
   void Binder::operator()(ast::LetExp& e)
   {
-    sm.scope_begin();
+    scope_begin();
     // visit ChunkList
     for (auto& it : e.chunks_get())
       {
@@ -363,7 +250,7 @@ namespace bind
       }
     // visit the body
     (*this)(e.body_get());
-    sm.scope_end();
+    scope_end();
   }
 
 } // namespace bind
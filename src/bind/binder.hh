@@ -5,16 +5,14 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include <stack>
-#include <tuple>
+#include <string_view>
 #include <ast/default-visitor.hh>
 #include <ast/object-visitor.hh>
 
 #include <misc/error.hh>
-#include <misc/fwd.hh>
 #include <misc/scoped-map.hh>
+#include <misc/symbol.hh>
 
 namespace bind
 {
@@ -49,11 +47,17 @@ namespace bind
     , public ast::ObjectVisitor
   {
   public:
-    // using for tuple
-    // to store the last scope assignation for FunctionDec, VarDec, TypeDec
-    using chunk_tracker = std::tuple<int, int, int>;
-    using binding_tuples =
-      std::tuple<ast::FunctionDec*, ast::VarDec*, ast::TypeDec*, chunk_tracker>;
+    /// A declaration, and the number of the chunk it belongs to (to
+    /// diagnose redefinitions within a chunk).
+    template <class D> struct binding
+    {
+      D* def;
+      int chunk;
+    };
+    /// An environment of a name space, keyed on interned symbols.
+    template <class D>
+    using env_type = misc::scoped_map<misc::symbol, binding<D>>;
+
     /// Super class type.
     using super_type = ast::DefaultVisitor;
     /// Import all the overloaded \c operator() methods.
@@ -105,13 +109,30 @@ namespace bind
 
     /// \}
 
+    /// \name Environments.
+    /// \{
+    /// The environment of the name space of \a D.
+    template <class D> env_type<D>& env_get();
+    /// Open a scope in every name space.
+    void scope_begin();
+    /// Close a scope in every name space.
+    void scope_end();
+    /// Bind \a e in its name space, unless it is a redefinition within
+    /// the current chunk.  \a kind names \a e in diagnostics.
+    template <class D> void dec_bind(D& e, std::string_view kind);
+    /// \}
+
   protected:
     /// Binding errors handler.
     misc::error error_;
 
     // FIXED: Some code was deleted here (More members).
-    // Scoped map to save bindings address
-    misc::scoped_map<const std::string, binding_tuples> sm;
+    /// The three name spaces, each in its own table.
+    env_type<ast::FunctionDec> funs_;
+    env_type<ast::VarDec> vars_;
+    env_type<ast::TypeDec> types_;
+    /// The number of chunks visited so far.
+    int nb_chunks_ = 0;
     // Stack to save for and while nodes
     std::stack<ast::Exp*> break_stack;
   };
@@ -3,4 +3,49 @@
  ** \brief Inline methods of bind::Binder.
  **/
 
-// FIXED: Some code was deleted here.
+#pragma once
+
+#include <type_traits>
+
+#include <bind/binder.hh>
+
+namespace bind
+{
+  template <class D> inline Binder::env_type<D>& Binder::env_get()
+  {
+    if constexpr (std::is_same_v<D, ast::FunctionDec>)
+      return funs_;
+    else if constexpr (std::is_same_v<D, ast::VarDec>)
+      return vars_;
+    else
+      return types_;
+  }
+
+  inline void Binder::scope_begin()
+  {
+    funs_.scope_begin();
+    vars_.scope_begin();
+    types_.scope_begin();
+  }
+
+  inline void Binder::scope_end()
+  {
+    funs_.scope_end();
+    vars_.scope_end();
+    types_.scope_end();
+  }
+
+  template <class D> void Binder::dec_bind(D& e, std::string_view kind)
+  {
+    env_type<D>& env = env_get<D>();
+    const binding<D>* previous = env.find(e.name_get());
+    if (previous != nullptr && previous->chunk == nb_chunks_)
+      this->error_ << misc::error::error_type::bind << e.location_get()
+                   << ": bind error, redefinition of " << kind << ' '
+                   << e.name_get() << "\n"
+                   << previous->def->location_get() << ": first definition\n";
+    else
+      env.put(e.name_get(), {&e, nb_chunks_});
+  }
+
+} // namespace bind
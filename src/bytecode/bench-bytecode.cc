@@ -0,0 +1,78 @@
+/**
+ ** \file bytecode/bench-bytecode.cc
+ ** \brief Compare the bytecode virtual machine to unoptimized LLVM code.
+ **
+ ** Build with `make src/bytecode/bench-bytecode', run on Tiger files,
+ ** their output being discarded, e.g.:
+ **
+ **   src/bytecode/bench-bytecode $(find tests/good -name '*.tig') \
+ **     >/dev/null </dev/null
+ **
+ ** Each program is run twice: compiled to bytecode and run by the
+ ** virtual machine, then translated to LLVM IR and run by the JIT
+ ** without optimization (as --llvm-run).  Both times include the
+ ** compilation, the startup cost being what the virtual machine is
+ ** meant for.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include <ast/chunk-list.hh>
+#include <bytecode/libbytecode.hh>
+#include <bytecode/program.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <misc/error.hh>
+#include <misc/file-library.hh>
+#include <misc/timer.hh>
+#include <parse/libparse.hh>
+
+const char* program_name = "bench-bytecode";
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+      std::cerr << "usage: " << program_name << " FILE...\n";
+      return EXIT_FAILURE;
+    }
+
+  misc::file_library library{PKGDATADIR};
+  misc::timer t;
+  t.start();
+  for (int i = 1; i < argc; ++i)
+    {
+      std::cerr << argv[i] << '\n';
+      auto [tree, e] =
+        parse::parse("builtin", argv[i], library, false, false);
+      std::unique_ptr<ast::ChunkList> program{tree};
+      if (!program || e)
+        {
+          std::cerr << e;
+          continue;
+        }
+      e << llvmtranslate::prepare(*program);
+      if (e)
+        {
+          std::cerr << e;
+          continue;
+        }
+
+      t.push("bytecode");
+      auto [bytecode, error] = bytecode::compile(*program);
+      if (error)
+        std::cerr << error;
+      else
+        bytecode::run(*bytecode);
+      t.pop("bytecode");
+
+      t.push("llvm -O0");
+      std::cerr << llvmtranslate::run(*program, false, 0);
+      t.pop("llvm -O0");
+    }
+  t.stop();
+
+  std::cerr << argc - 1 << " programs\n";
+  t.dump(std::cerr);
+}
@@ -0,0 +1,573 @@
+/**
+ ** \file bytecode/compiler.cc
+ ** \brief Implementation of bytecode::Compiler.
+ */
+
+#include <cstdint>
+
+#include <ast/all.hh>
+#include <bytecode/compiler.hh>
+#include <misc/contract.hh>
+#include <type/types.hh>
+
+namespace bytecode
+{
+  namespace
+  {
+    /// Whether values of type \a t are integers.
+    bool is_int(const type::Type& t)
+    {
+      return dynamic_cast<const type::Int*>(&t.actual());
+    }
+
+    /// Whether values of type \a t are unit.
+    bool is_void(const type::Type& t)
+    {
+      return dynamic_cast<const type::Void*>(&t.actual());
+    }
+
+    /// The jump taken when the comparison \a oper holds.
+    opcode jump_opcode(ast::OpExp::Oper oper, bool integers)
+    {
+      using Oper = ast::OpExp::Oper;
+      switch (oper)
+        {
+        case Oper::eq:
+          return integers ? opcode::jeq : opcode::jpeq;
+        case Oper::ne:
+          return integers ? opcode::jne : opcode::jpne;
+        case Oper::lt:
+          return opcode::jlt;
+        case Oper::le:
+          return opcode::jle;
+        case Oper::gt:
+          return opcode::jgt;
+        case Oper::ge:
+          return opcode::jge;
+        default:
+          unreachable();
+        }
+    }
+
+    /// The comparison that holds when \a oper does not.
+    ast::OpExp::Oper negate(ast::OpExp::Oper oper)
+    {
+      using Oper = ast::OpExp::Oper;
+      switch (oper)
+        {
+        case Oper::eq:
+          return Oper::ne;
+        case Oper::ne:
+          return Oper::eq;
+        case Oper::lt:
+          return Oper::ge;
+        case Oper::le:
+          return Oper::gt;
+        case Oper::gt:
+          return Oper::le;
+        case Oper::ge:
+          return Oper::lt;
+        default:
+          unreachable();
+        }
+    }
+
+    /// Whether \a e is a comparison that can be jumped on.
+    const ast::OpExp* comparison(const ast::Exp& e)
+    {
+      auto op = dynamic_cast<const ast::OpExp*>(&e);
+      return op && op->oper_get() >= ast::OpExp::Oper::eq ? op : nullptr;
+    }
+
+  } // namespace
+
+  Compiler::Compiler(Program& program,
+                     llvmtranslate::escaped_map_type&& escaped)
+    : program_{program}
+    , escaped_{std::move(escaped)}
+  {}
+
+  const misc::error& Compiler::error_get() const { return error_; }
+
+  void Compiler::operator()(const ast::ChunkList& e)
+  {
+    // Register the functions of the outermost chunks, then compile
+    // them and the ones they declare, in order.
+    super_type::operator()(e);
+    for (const auto& [f, index] : functions_)
+      if (f->name_get() == "_main")
+        program_.main_set(index);
+    precondition(program_.main_get() != -1);
+
+    while (!pending_.empty())
+      {
+        const ast::FunctionDec* f = pending_.front();
+        pending_.pop_front();
+        function_compile(*f);
+      }
+  }
+
+  /*------------.
+  | Registers.  |
+  `------------*/
+
+  Compiler::reg_type Compiler::temporary()
+  {
+    const reg_type res = next_++;
+    if (max_ < next_)
+      max_ = next_;
+    return res;
+  }
+
+  void Compiler::release(reg_type mark) { next_ = mark; }
+
+  void Compiler::compile(const ast::Exp& e, reg_type dst)
+  {
+    const reg_type saved = dst_;
+    dst_ = dst;
+    e.accept(*this);
+    dst_ = saved;
+  }
+
+  Compiler::reg_type Compiler::operand(const ast::Exp& e, bool direct)
+  {
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e);
+        direct && var && !var->def_get()->is_escaped())
+      return variable(*var->def_get());
+    const reg_type res = temporary();
+    compile(e, res);
+    return res;
+  }
+
+  bool Compiler::pure(const ast::Exp& e)
+  {
+    return dynamic_cast<const ast::IntExp*>(&e)
+      || dynamic_cast<const ast::StringExp*>(&e)
+      || dynamic_cast<const ast::NilExp*>(&e)
+      || dynamic_cast<const ast::SimpleVar*>(&e);
+  }
+
+  Compiler::reg_type Compiler::variable(const ast::VarDec& var) const
+  {
+    auto it = registers_.find(&var);
+    precondition(it != registers_.end());
+    return it->second;
+  }
+
+  /*-----------------.
+  | Code emission.  |
+  `-----------------*/
+
+  void Compiler::emit(opcode op, std::initializer_list<word> args)
+  {
+    assertion(static_cast<word>(args.size()) + 1 == size(op));
+    Program::code_type& code = program_.code_get();
+    code.push_back(static_cast<word>(op));
+    code.insert(code.end(), args);
+  }
+
+  word Compiler::here() const { return program_.code_get().size(); }
+
+  void Compiler::jump(patches_type& patches)
+  {
+    emit(opcode::jump, {-1});
+    patches.push_back(here() - 1);
+  }
+
+  void Compiler::branch(const ast::Exp& test, bool when, patches_type& patches)
+  {
+    const reg_type mark = next_;
+    if (const ast::OpExp* cmp = comparison(test))
+      {
+        const reg_type l = operand(cmp->left_get(), pure(cmp->right_get()));
+        const reg_type r = operand(cmp->right_get());
+        const auto oper = when ? cmp->oper_get() : negate(cmp->oper_get());
+        emit(jump_opcode(oper, is_int(*cmp->left_get().type_get())),
+             {l, r, -1});
+      }
+    else
+      {
+        const reg_type cond = operand(test);
+        emit(when ? opcode::jumpnz : opcode::jumpz, {cond, -1});
+      }
+    patches.push_back(here() - 1);
+    release(mark);
+  }
+
+  void Compiler::patch(const patches_type& patches, word target)
+  {
+    Program::code_type& code = program_.code_get();
+    for (word at : patches)
+      code[at] = target;
+  }
+
+  /*------------.
+  | Functions.  |
+  `------------*/
+
+  const std::vector<const ast::VarDec*>&
+  Compiler::lifted(const ast::FunctionDec& f)
+  {
+    auto [it, inserted] = lifted_.try_emplace(&f);
+    if (inserted)
+      // The escaping variables associated to F include its own ones,
+      // and the ones of the functions it calls.  Keep the ones it can
+      // see.
+      for (const ast::VarDec* var :
+           escaped_[static_cast<const type::Function*>(f.type_get())])
+        for (const ast::FunctionDec* p = parents_.at(&f); p;
+             p = parents_.at(p))
+          if (p == var->def_site_get())
+            {
+              it->second.push_back(var);
+              break;
+            }
+    return it->second;
+  }
+
+  void Compiler::function_compile(const ast::FunctionDec& f)
+  {
+    function_ = &f;
+    registers_.clear();
+    breaks_.clear();
+    next_ = 0;
+    max_ = 0;
+
+    const word index = functions_.at(&f);
+    program_.functions_get()[index].entry = here();
+
+    // The cells of the escaping variables, then the arguments.
+    for (const ast::VarDec* var : lifted(f))
+      registers_[var] = temporary();
+    for (const ast::VarDec* formal : f.formals_get())
+      {
+        const reg_type r = temporary();
+        registers_[formal] = r;
+        if (formal->is_escaped())
+          emit(opcode::box, {r, r});
+      }
+
+    program_.functions_get()[index].params = next_;
+
+    const reg_type res = temporary();
+    compile(*f.body_get(), res);
+    if (f.result_get())
+      emit(opcode::ret, {res});
+    else
+      emit(opcode::retv, {});
+
+    // The functions met in the body were added to the table meanwhile.
+    program_.functions_get()[index].registers = max_;
+  }
+
+  void Compiler::operator()(const ast::FunctionChunk& e)
+  {
+    for (const ast::FunctionDec* f : e)
+      if (!f->body_get())
+        {
+          primitive prim;
+          if (interpret::primitive_find(f->name_get().get().c_str(), prim))
+            primitives_[f] = prim;
+          else
+            error_ << misc::error::error_type::failure << f->location_get()
+                   << ": unsupported primitive " << f->name_get() << '\n';
+        }
+      else
+        {
+          // Functions are laid out in the order of the table.
+          functions_[f] = program_.functions_get().size();
+          parents_[f] = function_;
+          program_.functions_get().push_back({f->name_get().get()});
+          pending_.push_back(f);
+        }
+  }
+
+  void Compiler::operator()(const ast::CallExp& e)
+  {
+    const ast::FunctionDec& f = *e.def_get();
+    const reg_type first = next_;
+
+    // Lambda lifting: the cells of the escaping variables come first.
+    if (f.body_get())
+      for (const ast::VarDec* var : lifted(f))
+        emit(opcode::move, {temporary(), variable(*var)});
+    for (const ast::Exp* arg : e.args_get())
+      compile(*arg, temporary());
+
+    if (f.body_get())
+      emit(opcode::call, {dst_, functions_.at(&f), first});
+    // The unsupported primitives are reported already.
+    else if (auto it = primitives_.find(&f); it != primitives_.end())
+      emit(opcode::prim, {dst_, static_cast<word>(it->second), first});
+    release(first);
+  }
+
+  /*-----------.
+  | Lvalues.  |
+  `-----------*/
+
+  void Compiler::operator()(const ast::SimpleVar& e)
+  {
+    const ast::VarDec& var = *e.def_get();
+    const reg_type r = variable(var);
+    if (var.is_escaped())
+      emit(opcode::load, {dst_, r});
+    else if (r != dst_)
+      emit(opcode::move, {dst_, r});
+  }
+
+  void Compiler::operator()(const ast::FieldVar& e)
+  {
+    const reg_type mark = next_;
+    auto& type =
+      static_cast<const type::Record&>(e.var_get().type_get()->actual());
+    const reg_type record = operand(e.var_get());
+    emit(opcode::getf, {dst_, record, type.field_index(e.name_get())});
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::SubscriptVar& e)
+  {
+    const reg_type mark = next_;
+    const reg_type array = operand(e.var_get(), pure(e.index_get()));
+    const reg_type index = operand(e.index_get());
+    emit(opcode::geti, {dst_, array, index});
+    release(mark);
+  }
+
+  /*--------------.
+  | Expressions.  |
+  `--------------*/
+
+  void Compiler::operator()(const ast::NilExp&)
+  {
+    emit(opcode::loadi, {dst_, 0});
+  }
+
+  void Compiler::operator()(const ast::IntExp& e)
+  {
+    emit(opcode::loadi, {dst_, e.value_get()});
+  }
+
+  void Compiler::operator()(const ast::StringExp& e)
+  {
+    emit(opcode::loadk, {dst_, program_.constant(e.value_get())});
+  }
+
+  void Compiler::operator()(const ast::RecordExp& e)
+  {
+    const reg_type mark = next_;
+    auto& type = static_cast<const type::Record&>(e.type_get()->actual());
+
+    // Evaluate the fields first, so that they can refer to DST.
+    std::vector<std::pair<word, reg_type>> fields;
+    fields.reserve(e.fields_get().size());
+    for (const ast::FieldInit* field : e.fields_get())
+      fields.emplace_back(type.field_index(field->name_get()),
+                          operand(field->init_get(), false));
+
+    emit(opcode::record, {dst_, static_cast<word>(type.fields_get().size())});
+    for (const auto& [index, value] : fields)
+      emit(opcode::setf, {dst_, index, value});
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::ArrayExp& e)
+  {
+    const reg_type mark = next_;
+    const reg_type size = operand(e.size_get(), pure(e.init_get()));
+    const reg_type init = operand(e.init_get());
+    emit(opcode::array, {dst_, size, init});
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::OpExp& e)
+  {
+    using Oper = ast::OpExp::Oper;
+    const reg_type mark = next_;
+    const Oper oper = e.oper_get();
+
+    // Additions and subtractions of a constant.
+    auto constant = dynamic_cast<const ast::IntExp*>(&e.right_get());
+    if (constant && (oper == Oper::add || oper == Oper::sub))
+      {
+        const auto value = static_cast<std::uint32_t>(constant->value_get());
+        const reg_type l = operand(e.left_get());
+        emit(opcode::addi,
+             {dst_, l,
+              static_cast<word>(oper == Oper::add ? value : 0u - value)});
+        release(mark);
+        return;
+      }
+
+    const reg_type l = operand(e.left_get(), pure(e.right_get()));
+    const reg_type r = operand(e.right_get());
+    const bool integers = is_int(*e.left_get().type_get());
+    opcode op = opcode::add;
+    switch (oper)
+      {
+      case Oper::add:
+        op = opcode::add;
+        break;
+      case Oper::sub:
+        op = opcode::sub;
+        break;
+      case Oper::mul:
+        op = opcode::mul;
+        break;
+      case Oper::div:
+        op = opcode::div;
+        break;
+      case Oper::eq:
+        op = integers ? opcode::eq : opcode::peq;
+        break;
+      case Oper::ne:
+        op = integers ? opcode::ne : opcode::pne;
+        break;
+      case Oper::lt:
+        op = opcode::lt;
+        break;
+      case Oper::le:
+        op = opcode::le;
+        break;
+      case Oper::gt:
+        op = opcode::gt;
+        break;
+      case Oper::ge:
+        op = opcode::ge;
+        break;
+      }
+    emit(op, {dst_, l, r});
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::SeqExp& e)
+  {
+    // Only the last expression is computed into DST, which may be a
+    // variable read by the others.
+    const ast::exps_type& exps = e.exps_get();
+    for (std::size_t i = 0; i < exps.size(); ++i)
+      if (i + 1 == exps.size())
+        compile(*exps[i], dst_);
+      else
+        {
+          const reg_type mark = next_;
+          compile(*exps[i], temporary());
+          release(mark);
+        }
+  }
+
+  void Compiler::operator()(const ast::AssignExp& e)
+  {
+    const reg_type mark = next_;
+    const ast::Var& var = e.var_get();
+    // As the translator, evaluate the value first.
+    if (auto simple = dynamic_cast<const ast::SimpleVar*>(&var))
+      {
+        const ast::VarDec& dec = *simple->def_get();
+        if (dec.is_escaped())
+          emit(opcode::store, {variable(dec), operand(e.exp_get())});
+        else
+          compile(e.exp_get(), variable(dec));
+      }
+    else if (auto field = dynamic_cast<const ast::FieldVar*>(&var))
+      {
+        auto& type = static_cast<const type::Record&>(
+          field->var_get().type_get()->actual());
+        const reg_type value =
+          operand(e.exp_get(), pure(field->var_get()));
+        const reg_type record = operand(field->var_get());
+        emit(opcode::setf,
+             {record, type.field_index(field->name_get()), value});
+      }
+    else
+      {
+        auto& subscript = static_cast<const ast::SubscriptVar&>(var);
+        const reg_type value =
+          operand(e.exp_get(),
+                  pure(subscript.var_get()) && pure(subscript.index_get()));
+        const reg_type array =
+          operand(subscript.var_get(), pure(subscript.index_get()));
+        const reg_type index = operand(subscript.index_get());
+        emit(opcode::seti, {array, index, value});
+      }
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::IfExp& e)
+  {
+    patches_type otherwise;
+    branch(e.test_get(), false, otherwise);
+    compile(e.thenclause_get(), dst_);
+
+    auto elseclause = dynamic_cast<const ast::SeqExp*>(&e.elseclause_get());
+    if (elseclause && elseclause->exps_get().empty())
+      patch(otherwise, here());
+    else
+      {
+        patches_type end;
+        jump(end);
+        patch(otherwise, here());
+        compile(e.elseclause_get(), dst_);
+        patch(end, here());
+      }
+  }
+
+  void Compiler::operator()(const ast::WhileExp& e)
+  {
+    // Test at the bottom: one jump per iteration.
+    patches_type test;
+    jump(test);
+    const word body = here();
+    const reg_type mark = next_;
+    compile(e.body_get(), temporary());
+    release(mark);
+    patch(test, here());
+
+    patches_type loop;
+    branch(e.test_get(), true, loop);
+    patch(loop, body);
+    patch(breaks_[&e], here());
+  }
+
+  void Compiler::operator()(const ast::BreakExp& e)
+  {
+    jump(breaks_[e.def_get()]);
+  }
+
+  void Compiler::operator()(const ast::LetExp& e)
+  {
+    // The variables of the let live until its end.
+    const reg_type mark = next_;
+    // Not operator()(const ast::ChunkList&), which compiles a program.
+    super_type::operator()(e.chunks_get());
+    compile(e.body_get(), dst_);
+    release(mark);
+  }
+
+  void Compiler::operator()(const ast::CastExp& e)
+  {
+    compile(e.exp_get(), dst_);
+  }
+
+  /*---------------.
+  | Declarations.  |
+  `---------------*/
+
+  void Compiler::operator()(const ast::VarDec& e)
+  {
+    const reg_type r = temporary();
+    compile(*e.init_get(), r);
+    if (is_void(*e.type_get()))
+      emit(opcode::loadi, {r, 0});
+    if (e.is_escaped())
+      emit(opcode::box, {r, r});
+    registers_[&e] = r;
+  }
+
+  void Compiler::operator()(const ast::TypeChunk&)
+  {
+    // Nothing to compile.
+  }
+
+} // namespace bytecode
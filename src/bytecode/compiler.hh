@@ -0,0 +1,167 @@
+/**
+ ** \file bytecode/compiler.hh
+ ** \brief Declaration of bytecode::Compiler.
+ */
+
+#pragma once
+
+#include <deque>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <bytecode/fwd.hh>
+#include <bytecode/opcode.hh>
+#include <bytecode/program.hh>
+#include <llvmtranslate/fwd.hh>
+#include <misc/error.hh>
+
+namespace bytecode
+{
+  /** \brief Compile a typed and desugared program to bytecode.
+   **
+   ** Each function has its own frame of registers, the arguments
+   ** coming first.  Every variable lives in a register of its own;
+   ** expressions are computed into the register given by their parent,
+   ** using the registers above the variables as temporaries.
+   **
+   ** Nested functions are lifted as in llvmtranslate::Translator: the
+   ** variables that escape are stored in heap cells, and the cells are
+   ** passed to the functions that use them, before their arguments.
+   **/
+  class Compiler
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import overloaded operator() methods.
+    using super_type::operator();
+
+    /// Compile into \a program, lifting the functions as told by
+    /// \a escaped.
+    Compiler(Program& program, llvmtranslate::escaped_map_type&& escaped);
+
+    /// Compile \a e, the whole program.
+    void operator()(const ast::ChunkList& e) override;
+
+    /// The errors, e.g., the primitives which are not supported.
+    const misc::error& error_get() const;
+
+    /// \name Lvalues
+    /// \{
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    /// \}
+
+    /// \name Expressions
+    /// \{
+    void operator()(const ast::NilExp&) override;
+    void operator()(const ast::IntExp& e) override;
+    void operator()(const ast::StringExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    void operator()(const ast::BreakExp& e) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::CastExp& e) override;
+    /// \}
+
+    /// \name Declarations
+    /// \{
+    void operator()(const ast::FunctionChunk& e) override;
+    void operator()(const ast::VarDec& e) override;
+    void operator()(const ast::TypeChunk&) override;
+    /// \}
+
+  private:
+    /// A register, i.e., an index in the frame.
+    using reg_type = word;
+    /// The offsets of jump operands waiting for their target.
+    using patches_type = std::vector<word>;
+
+    /// \name Registers.
+    /// \{
+    /// A fresh temporary register.
+    reg_type temporary();
+    /// Release the temporaries allocated since \a mark.
+    void release(reg_type mark);
+    /// Compute \a e into \a dst.
+    void compile(const ast::Exp& e, reg_type dst);
+    /// A register holding the value of \a e: the register of a
+    /// variable when \a direct and \a e is one, otherwise a fresh
+    /// temporary.
+    reg_type operand(const ast::Exp& e, bool direct = true);
+    /// Whether evaluating \a e cannot change any variable.
+    static bool pure(const ast::Exp& e);
+    /// The register of \a var, or of its cell if it escapes.
+    reg_type variable(const ast::VarDec& var) const;
+    /// \}
+
+    /// \name Code emission.
+    /// \{
+    /// Emit \a op with its \a args.
+    void emit(opcode op, std::initializer_list<word> args);
+    /// The offset of the next instruction.
+    word here() const;
+    /// Emit a jump to an unknown target, to be patched in \a patches.
+    void jump(patches_type& patches);
+    /// Emit a jump to an unknown target taken if \a test is \a when.
+    void branch(const ast::Exp& test, bool when, patches_type& patches);
+    /// Make the jumps of \a patches go to \a target.
+    void patch(const patches_type& patches, word target);
+    /// \}
+
+    /// Compile the body of \a f.
+    void function_compile(const ast::FunctionDec& f);
+    /// The cells given to \a f: the escaping variables it uses, or
+    /// that the functions it calls use, declared by the functions in
+    /// which \a f is nested.
+    const std::vector<const ast::VarDec*>& lifted(const ast::FunctionDec& f);
+
+    Program& program_;
+    llvmtranslate::escaped_map_type escaped_;
+
+    /// The index of each function in the function table.
+    std::unordered_map<const ast::FunctionDec*, word> functions_;
+    /// The function in which each function is declared, if any.
+    std::unordered_map<const ast::FunctionDec*, const ast::FunctionDec*>
+      parents_;
+    /// The primitive denoted by each primitive declaration.
+    std::unordered_map<const ast::FunctionDec*, primitive> primitives_;
+    /// The cells given to each function.
+    std::unordered_map<const ast::FunctionDec*,
+                       std::vector<const ast::VarDec*>>
+      lifted_;
+    /// The functions met but not compiled yet.
+    std::deque<const ast::FunctionDec*> pending_;
+    /// The errors.
+    misc::error error_;
+
+    /// \name The function being compiled.
+    /// \{
+    const ast::FunctionDec* function_ = nullptr;
+    /// The register of each of its variables.
+    std::unordered_map<const ast::VarDec*, reg_type> registers_;
+    /// The first free register.
+    reg_type next_ = 0;
+    /// The size of the frame.
+    reg_type max_ = 0;
+    /// The jumps out of each loop.
+    std::unordered_map<const ast::Exp*, patches_type> breaks_;
+    /// \}
+
+    /// The register the current expression is computed into.
+    reg_type dst_ = 0;
+  };
+
+} // namespace bytecode
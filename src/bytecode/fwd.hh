@@ -0,0 +1,33 @@
+/**
+ ** \file bytecode/fwd.hh
+ ** \brief Forward declarations for the bytecode module.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <interpret/fwd.hh>
+
+namespace bytecode
+{
+  /// A word of bytecode: an opcode, or one of its operands.
+  using word = std::int32_t;
+
+  // From opcode.hh.
+  enum class opcode : word;
+
+  /// The primitives and the values are those of the interpreter.
+  using interpret::primitive;
+  using interpret::value;
+
+  // From program.hh.
+  class Program;
+
+  // From compiler.hh.
+  class Compiler;
+
+  // From vm.hh.
+  class Vm;
+
+} // namespace bytecode
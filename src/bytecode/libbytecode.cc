@@ -0,0 +1,30 @@
+/**
+ ** \file bytecode/libbytecode.cc
+ ** \brief Define exported bytecode functions.
+ */
+
+#include <ast/chunk-list.hh>
+#include <bytecode/compiler.hh>
+#include <bytecode/libbytecode.hh>
+#include <bytecode/program.hh>
+#include <bytecode/vm.hh>
+#include <llvmtranslate/escapes-collector.hh>
+
+namespace bytecode
+{
+  std::pair<std::unique_ptr<Program>, misc::error>
+  compile(const ast::ChunkList& the_program)
+  {
+    auto res = std::make_unique<Program>();
+    Compiler compile{*res, llvmtranslate::collect_escapes(the_program)};
+    compile(the_program);
+    return {std::move(res), compile.error_get()};
+  }
+
+  void run(const Program& program)
+  {
+    Vm vm{program};
+    vm();
+  }
+
+} // namespace bytecode
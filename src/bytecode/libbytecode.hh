@@ -0,0 +1,27 @@
+/**
+ ** \file bytecode/libbytecode.hh
+ ** \brief Public bytecode module interface declaration.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include <ast/fwd.hh>
+#include <bytecode/fwd.hh>
+#include <misc/error.hh>
+
+/// Compilation of ast::Ast to bytecode, and its virtual machine.
+namespace bytecode
+{
+  /// Compile \a the_program, typed and desugared, its escapes being
+  /// computed.  The primitives that tc does not provide are reported
+  /// in the error, and the program is then not to be run.
+  std::pair<std::unique_ptr<Program>, misc::error>
+  compile(const ast::ChunkList& the_program);
+
+  /// Run \a program.
+  void run(const Program& program);
+
+} // namespace bytecode
@@ -0,0 +1,43 @@
+/**
+ ** \file bytecode/opcode.cc
+ ** \brief Implementation of the bytecode instruction set.
+ */
+
+#include <cstring>
+#include <ostream>
+
+#include <bytecode/opcode.hh>
+
+namespace bytecode
+{
+  namespace
+  {
+    struct opcode_info
+    {
+      const char* name;
+      const char* operands;
+    };
+
+    constexpr opcode_info opcodes[] = {
+#define BYTECODE_OPCODE(Name, Operands) {#Name, Operands},
+      BYTECODE_OPCODES(BYTECODE_OPCODE)
+#undef BYTECODE_OPCODE
+    };
+
+  } // namespace
+
+  const char* name(opcode op) { return opcodes[static_cast<word>(op)].name; }
+
+  const char* operands(opcode op)
+  {
+    return opcodes[static_cast<word>(op)].operands;
+  }
+
+  word size(opcode op) { return 1 + std::strlen(operands(op)); }
+
+  std::ostream& operator<<(std::ostream& ostr, opcode op)
+  {
+    return ostr << name(op);
+  }
+
+} // namespace bytecode
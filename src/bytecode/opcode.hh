@@ -0,0 +1,95 @@
+/**
+ ** \file bytecode/opcode.hh
+ ** \brief Declaration of the bytecode instruction set.
+ **
+ ** An instruction is a word holding its opcode, followed by one word
+ ** per operand.  The operands of an opcode are described by a string,
+ ** one letter per operand:
+ **
+ ** - `r': a register, i.e., an index in the frame of the function;
+ ** - `i': an immediate integer;
+ ** - `k': an index in the constant pool;
+ ** - `f': an index in the function table;
+ ** - `p': a primitive, shared with the interpreter;
+ ** - `l': the offset of an instruction in the code.
+ **
+ ** The first register operand is the destination, if any.
+ **/
+
+#pragma once
+
+#include <iosfwd>
+
+#include <bytecode/fwd.hh>
+#include <interpret/primitive.hh>
+
+/// The opcodes, as X(Name, Operands).
+#define BYTECODE_OPCODES(X)                                                    \
+  /* Moves and constants. */                                                   \
+  X(move, "rr")                                                                \
+  X(loadi, "ri")                                                               \
+  X(loadk, "rk")                                                               \
+  /* Arithmetics. */                                                           \
+  X(add, "rrr")                                                                \
+  X(addi, "rri")                                                               \
+  X(sub, "rrr")                                                                \
+  X(mul, "rrr")                                                                \
+  X(div, "rrr")                                                                \
+  /* Comparisons of integers, then of pointers. */                             \
+  X(eq, "rrr")                                                                 \
+  X(ne, "rrr")                                                                 \
+  X(lt, "rrr")                                                                 \
+  X(le, "rrr")                                                                 \
+  X(gt, "rrr")                                                                 \
+  X(ge, "rrr")                                                                 \
+  X(peq, "rrr")                                                                \
+  X(pne, "rrr")                                                                \
+  /* Jumps, unconditional, on a register, or on a comparison. */               \
+  X(jump, "l")                                                                 \
+  X(jumpz, "rl")                                                               \
+  X(jumpnz, "rl")                                                              \
+  X(jeq, "rrl")                                                                \
+  X(jne, "rrl")                                                                \
+  X(jlt, "rrl")                                                                \
+  X(jle, "rrl")                                                                \
+  X(jgt, "rrl")                                                                \
+  X(jge, "rrl")                                                                \
+  X(jpeq, "rrl")                                                               \
+  X(jpne, "rrl")                                                               \
+  /* Calls: the arguments are in the registers from the second operand. */     \
+  X(call, "rfr")                                                               \
+  X(prim, "rpr")                                                               \
+  X(ret, "r")                                                                  \
+  X(retv, "")                                                                  \
+  /* Cells of the escaping variables. */                                       \
+  X(box, "rr")                                                                 \
+  X(load, "rr")                                                                \
+  X(store, "rr")                                                               \
+  /* Records. */                                                               \
+  X(record, "ri")                                                              \
+  X(getf, "rri")                                                               \
+  X(setf, "rir")                                                               \
+  /* Arrays. */                                                                \
+  X(array, "rrr")                                                              \
+  X(geti, "rrr")                                                               \
+  X(seti, "rrr")
+
+namespace bytecode
+{
+  enum class opcode : word
+  {
+#define BYTECODE_OPCODE(Name, Operands) Name,
+    BYTECODE_OPCODES(BYTECODE_OPCODE)
+#undef BYTECODE_OPCODE
+  };
+
+  /// The mnemonic of \a op.
+  const char* name(opcode op);
+  /// The operands of \a op, one letter each.
+  const char* operands(opcode op);
+  /// The size of an instruction \a op, in words.
+  word size(opcode op);
+
+  std::ostream& operator<<(std::ostream& ostr, opcode op);
+
+} // namespace bytecode
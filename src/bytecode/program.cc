@@ -0,0 +1,76 @@
+/**
+ ** \file bytecode/program.cc
+ ** \brief Implementation of bytecode::Program.
+ */
+
+#include <ostream>
+
+#include <bytecode/opcode.hh>
+#include <bytecode/program.hh>
+#include <misc/escape.hh>
+
+namespace bytecode
+{
+  word Program::constant(const std::string& s)
+  {
+    auto [it, inserted] = constant_indexes_.try_emplace(s, constants_.size());
+    if (inserted)
+      constants_.push_back(s);
+    return it->second;
+  }
+
+  std::ostream& Program::dump(std::ostream& ostr) const
+  {
+    ostr << "/* Constants. */\n";
+    for (word k = 0; k < static_cast<word>(constants_.size()); ++k)
+      ostr << 'k' << k << " = \"" << misc::escape(constants_[k]) << "\"\n";
+
+    // Functions are laid out in the order of the table.
+    for (const function& f : functions_)
+      {
+        const word end = &f == &functions_.back()
+          ? static_cast<word>(code_.size())
+          : (&f)[1].entry;
+        ostr << "\n/* " << f.name << " (arguments: " << f.params
+             << ", registers: " << f.registers << "). */\n";
+        for (word pc = f.entry; pc < end;)
+          {
+            const auto op = static_cast<opcode>(code_[pc]);
+            ostr << pc << ":\t" << op;
+            const char* kinds = operands(op);
+            for (word i = 0; kinds[i]; ++i)
+              {
+                const word arg = code_[pc + 1 + i];
+                ostr << (i ? ", " : " ");
+                switch (kinds[i])
+                  {
+                  case 'r':
+                    ostr << 'r' << arg;
+                    break;
+                  case 'k':
+                    ostr << 'k' << arg;
+                    break;
+                  case 'f':
+                    ostr << functions_[arg].name;
+                    break;
+                  case 'p':
+                    ostr << static_cast<primitive>(arg);
+                    break;
+                  default:
+                    ostr << arg;
+                    break;
+                  }
+              }
+            ostr << '\n';
+            pc += size(op);
+          }
+      }
+    return ostr;
+  }
+
+  std::ostream& operator<<(std::ostream& ostr, const Program& p)
+  {
+    return p.dump(ostr);
+  }
+
+} // namespace bytecode
@@ -0,0 +1,75 @@
+/**
+ ** \file bytecode/program.hh
+ ** \brief Declaration of bytecode::Program.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <bytecode/fwd.hh>
+
+namespace bytecode
+{
+  /** \brief A program compiled to bytecode.
+   **
+   ** The code of all the functions lies in a single buffer of words.
+   ** String literals are not part of it: they are kept in a constant
+   ** pool, and referred to by their index.
+   **/
+  class Program
+  {
+  public:
+    /// A function of the program.
+    struct function
+    {
+      /// Its (unique) name.
+      std::string name;
+      /// The offset of its first instruction.
+      word entry = 0;
+      /// Number of arguments, escaping variables included.
+      word params = 0;
+      /// Number of registers of its frame, arguments included.
+      word registers = 0;
+    };
+
+    using code_type = std::vector<word>;
+    using constants_type = std::vector<std::string>;
+    using functions_type = std::vector<function>;
+
+    /// \name Accessors.
+    /// \{
+    const code_type& code_get() const;
+    code_type& code_get();
+    const constants_type& constants_get() const;
+    const functions_type& functions_get() const;
+    functions_type& functions_get();
+    /// The index of _main in the function table.
+    word main_get() const;
+    void main_set(word main);
+    /// \}
+
+    /// The index of \a s in the constant pool, adding it if needed.
+    word constant(const std::string& s);
+
+    /// Print the constant pool and the code, function by function.
+    std::ostream& dump(std::ostream& ostr) const;
+
+  private:
+    code_type code_;
+    constants_type constants_;
+    /// The index of each constant.
+    std::unordered_map<std::string, word> constant_indexes_;
+    functions_type functions_;
+    word main_ = -1;
+  };
+
+  /// Report \a p on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const Program& p);
+
+} // namespace bytecode
+
+#include <bytecode/program.hxx>
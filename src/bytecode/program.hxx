@@ -0,0 +1,35 @@
+/**
+ ** \file bytecode/program.hxx
+ ** \brief Inline methods of bytecode::Program.
+ */
+
+#pragma once
+
+#include <bytecode/program.hh>
+
+namespace bytecode
+{
+  inline const Program::code_type& Program::code_get() const { return code_; }
+
+  inline Program::code_type& Program::code_get() { return code_; }
+
+  inline const Program::constants_type& Program::constants_get() const
+  {
+    return constants_;
+  }
+
+  inline const Program::functions_type& Program::functions_get() const
+  {
+    return functions_;
+  }
+
+  inline Program::functions_type& Program::functions_get()
+  {
+    return functions_;
+  }
+
+  inline word Program::main_get() const { return main_; }
+
+  inline void Program::main_set(word main) { main_ = main; }
+
+} // namespace bytecode
@@ -0,0 +1,31 @@
+/**
+ ** \file bytecode/tasks.cc
+ ** \brief Bytecode module related tasks' implementation.
+ */
+
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <bytecode/libbytecode.hh>
+#include <bytecode/program.hh>
+#include <common.hh>
+#define DEFINE_TASKS 1
+#include <bytecode/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace bytecode::tasks
+{
+  std::unique_ptr<Program> program;
+
+  void bytecode_compute()
+  {
+    auto [res, error] = compile(*ast::tasks::the_program);
+    task_error() << error << &misc::error::exit_on_error;
+    program = std::move(res);
+  }
+
+  void bytecode_display() { std::cout << *program; }
+
+  void bytecode_run() { run(*program); }
+
+} // namespace bytecode::tasks
@@ -0,0 +1,39 @@
+/**
+ ** \file bytecode/tasks.hh
+ ** \brief Bytecode module related tasks.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <bytecode/fwd.hh>
+#include <task/libtask.hh>
+
+/// Tasks of the bytecode module.
+namespace bytecode::tasks
+{
+  /// The program compiled to bytecode.
+  extern std::unique_ptr<Program> program;
+
+  TASK_GROUP("5.7. Bytecode");
+
+  /// Compile to bytecode.
+  TASK_DECLARE("bytecode-compute",
+               "compile to bytecode",
+               bytecode_compute,
+               "typed desugar-for desugar-string-cmp desugar escapes-compute");
+
+  /// Display the bytecode.
+  TASK_DECLARE("bytecode-display",
+               "display the bytecode",
+               bytecode_display,
+               "bytecode-compute");
+
+  /// Run the bytecode.
+  TASK_DECLARE("bytecode-run",
+               "run the bytecode in the virtual machine of tc",
+               bytecode_run,
+               "bytecode-compute");
+
+} // namespace bytecode::tasks
@@ -0,0 +1,63 @@
+/**
+ ** Checking the compilation to bytecode, and its virtual machine.
+ */
+
+#include <iostream>
+
+#include <ast/all.hh>
+#include <bytecode/libbytecode.hh>
+#include <bytecode/program.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <misc/contract.hh>
+#include <parse/libparse.hh>
+
+using namespace ast;
+
+const char* program_name = "test-bytecode";
+
+int main()
+{
+  ChunkList* tree = parse::parse_unit(
+    "let primitive print(string : string)\n"
+    "    primitive print_int(int : int)\n"
+    "    primitive concat(fst : string, snd : string) : string\n"
+    "    primitive streq(s1 : string, s2 : string) : int\n"
+    "    type list = { head : int, tail : list }\n"
+    "    type ints = array of int\n"
+    "    function fib(n : int) : int =\n"
+    "      if n < 2 then n else fib(n - 1) + fib(n - 2)\n"
+    "    function sum(l : list) : int =\n"
+    "      if l = nil then 0 else l.head + sum(l.tail)\n"
+    "    var total := 0\n"
+    "    function add(n : int) =\n"
+    "      let function twice() = total := total + 2 * n\n"
+    "      in twice() end\n"
+    "    var l : list := nil\n"
+    "    var a := ints [10] of 1\n"
+    "    var s := \"\"\n"
+    "in\n"
+    "  print_int(fib(20)); print(\"\\n\");\n"
+    "  for i := 1 to 10 do (l := list { head = i, tail = l }; add(i));\n"
+    "  print_int(sum(l)); print(\" \"); print_int(total); print(\"\\n\");\n"
+    "  for i := 1 to 9 do a[i] := a[i - 1] * 2;\n"
+    "  print_int(a[9]); print(\"\\n\");\n"
+    "  while 1 do (s := concat(s, \"ab\"); if s = \"ababab\" then break);\n"
+    "  print(s); print(\"\\n\")\n"
+    "end\n");
+  llvmtranslate::prepare(*tree).ice_on_error_here();
+
+  auto [program, e] = bytecode::compile(*tree);
+  assertion(!e);
+  std::cout << "/* === Bytecode...  */\n" << *program << '\n'
+            << "/* === Output...  */\n"
+            << std::flush;
+  bytecode::run(*program);
+  delete tree;
+
+  // A primitive that tc does not provide is reported.
+  ChunkList* unsupported =
+    parse::parse_unit("let primitive foo() in foo() end\n");
+  llvmtranslate::prepare(*unsupported).ice_on_error_here();
+  assertion(bytecode::compile(*unsupported).second);
+  delete unsupported;
+}
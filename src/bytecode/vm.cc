@@ -0,0 +1,321 @@
+/**
+ ** \file bytecode/vm.cc
+ ** \brief Implementation of bytecode::Vm.
+ */
+
+#include <cstdint>
+
+#include <bytecode/opcode.hh>
+#include <bytecode/vm.hh>
+#include <interpret/primitive.hh>
+#include <llvmtranslate/tiger-runtime.h>
+#include <misc/contract.hh>
+
+#if defined __GNUC__
+#  define BYTECODE_COMPUTED_GOTO 1
+#else
+#  define BYTECODE_COMPUTED_GOTO 0
+#endif
+
+namespace bytecode
+{
+  namespace
+  {
+    /// The value of the integer \a i, the rest of the word being null.
+    inline value integer(std::int32_t i)
+    {
+      value res;
+      res.p = nullptr;
+      res.i = i;
+      return res;
+    }
+
+    /// Integers wrap around, as in compiled code.
+    inline std::int32_t wrap(std::uint32_t i)
+    {
+      return static_cast<std::int32_t>(i);
+    }
+
+    inline std::uint32_t unsigned_of(value v)
+    {
+      return static_cast<std::uint32_t>(v.i);
+    }
+
+  } // namespace
+
+  Vm::Vm(const Program& program, std::size_t stack_size)
+    : program_{program}
+    , stack_(stack_size)
+  {
+    constants_.reserve(program_.constants_get().size());
+    for (const std::string& s : program_.constants_get())
+      constants_.push_back(tc_string(s.data(), s.size()));
+  }
+
+  void Vm::operator()()
+  {
+    const Program::function& main =
+      program_.functions_get()[program_.main_get()];
+    if (static_cast<std::size_t>(main.registers) > stack_.size())
+      tc_runtime_failure("stack overflow");
+    tc_runtime_init();
+    frames_.clear();
+    run(program_.code_get().data() + main.entry, stack_.data());
+    // As exit would do at the end of a compiled program.
+    tc_flush();
+  }
+
+  void Vm::run(const word* pc, value* base)
+  {
+    const word* const code = program_.code_get().data();
+    const Program::function* const functions =
+      program_.functions_get().data();
+    const char* const* const constants = constants_.data();
+    const value* const stack_end = stack_.data() + stack_.size();
+
+    // The registers operands of the current instruction.
+#define R(N) base[pc[N]]
+
+#if BYTECODE_COMPUTED_GOTO
+    static const void* const labels[] = {
+#  define BYTECODE_OPCODE(Name, Operands) &&op_##Name,
+      BYTECODE_OPCODES(BYTECODE_OPCODE)
+#  undef BYTECODE_OPCODE
+    };
+#  define DISPATCH() goto *labels[*pc]
+#  define OP(Name, Operands) op_##Name:
+    DISPATCH();
+#else
+#  define DISPATCH() continue
+#  define OP(Name, Operands) case opcode::Name:
+    for (;;)
+      switch (static_cast<opcode>(*pc))
+        {
+#endif
+
+    // The size of an instruction, in words: its operands, plus its
+    // opcode (counted as the trailing NUL).
+#define SIZE(Operands) (sizeof(Operands))
+
+    OP(move, "rr")
+    {
+      R(1) = R(2);
+      pc += SIZE("rr");
+      DISPATCH();
+    }
+    OP(loadi, "ri")
+    {
+      R(1) = integer(pc[2]);
+      pc += SIZE("ri");
+      DISPATCH();
+    }
+    OP(loadk, "rk")
+    {
+      R(1).s = constants[pc[2]];
+      pc += SIZE("rk");
+      DISPATCH();
+    }
+
+#define ARITHMETIC(Name, Expr)                                                 \
+  OP(Name, "rrr")                                                              \
+  {                                                                            \
+    const std::uint32_t l = unsigned_of(R(2));                                 \
+    const std::uint32_t r = unsigned_of(R(3));                                 \
+    R(1) = integer(wrap(Expr));                                                \
+    pc += SIZE("rrr");                                                         \
+    DISPATCH();                                                                \
+  }
+    ARITHMETIC(add, l + r)
+    ARITHMETIC(sub, l - r)
+    ARITHMETIC(mul, l * r)
+#undef ARITHMETIC
+    OP(addi, "rri")
+    {
+      const auto imm = static_cast<std::uint32_t>(pc[3]);
+      R(1) = integer(wrap(unsigned_of(R(2)) + imm));
+      pc += SIZE("rri");
+      DISPATCH();
+    }
+    OP(div, "rrr")
+    {
+      const std::int32_t l = R(2).i;
+      const std::int32_t r = R(3).i;
+      if (!r)
+        tc_runtime_failure("division by zero");
+      // INT_MIN / -1 overflows.
+      R(1) = integer(r == -1 ? wrap(0u - unsigned_of(R(2))) : l / r);
+      pc += SIZE("rrr");
+      DISPATCH();
+    }
+
+#define COMPARISON(Name, Field, Op)                                            \
+  OP(Name, "rrr")                                                              \
+  {                                                                            \
+    R(1) = integer(R(2).Field Op R(3).Field);                                  \
+    pc += SIZE("rrr");                                                         \
+    DISPATCH();                                                                \
+  }
+    COMPARISON(eq, i, ==)
+    COMPARISON(ne, i, !=)
+    COMPARISON(lt, i, <)
+    COMPARISON(le, i, <=)
+    COMPARISON(gt, i, >)
+    COMPARISON(ge, i, >=)
+    COMPARISON(peq, p, ==)
+    COMPARISON(pne, p, !=)
+#undef COMPARISON
+
+    OP(jump, "l")
+    {
+      pc = code + pc[1];
+      DISPATCH();
+    }
+    OP(jumpz, "rl")
+    {
+      pc = R(1).i ? pc + SIZE("rl") : code + pc[2];
+      DISPATCH();
+    }
+    OP(jumpnz, "rl")
+    {
+      pc = R(1).i ? code + pc[2] : pc + SIZE("rl");
+      DISPATCH();
+    }
+
+#define BRANCH(Name, Field, Op)                                                \
+  OP(Name, "rrl")                                                              \
+  {                                                                            \
+    pc = R(1).Field Op R(2).Field ? code + pc[3] : pc + SIZE("rrl");           \
+    DISPATCH();                                                                \
+  }
+    BRANCH(jeq, i, ==)
+    BRANCH(jne, i, !=)
+    BRANCH(jlt, i, <)
+    BRANCH(jle, i, <=)
+    BRANCH(jgt, i, >)
+    BRANCH(jge, i, >=)
+    BRANCH(jpeq, p, ==)
+    BRANCH(jpne, p, !=)
+#undef BRANCH
+
+    OP(call, "rfr")
+    {
+      const Program::function& f = functions[pc[2]];
+      value* callee = base + pc[3];
+      if (callee + f.registers > stack_end)
+        tc_runtime_failure("stack overflow");
+      frames_.push_back({pc + SIZE("rfr"), base, pc[1]});
+      base = callee;
+      pc = code + f.entry;
+      DISPATCH();
+    }
+    OP(prim, "rpr")
+    {
+      R(1) = interpret::primitive_call(static_cast<primitive>(pc[2]),
+                                      base + pc[3]);
+      pc += SIZE("rpr");
+      DISPATCH();
+    }
+    OP(ret, "r")
+    {
+      const value res = R(1);
+      if (frames_.empty())
+        return;
+      const frame& caller = frames_.back();
+      pc = caller.pc;
+      base = caller.base;
+      base[caller.dst] = res;
+      frames_.pop_back();
+      DISPATCH();
+    }
+    OP(retv, "")
+    {
+      if (frames_.empty())
+        return;
+      const frame& caller = frames_.back();
+      pc = caller.pc;
+      base = caller.base;
+      base[caller.dst] = integer(0);
+      frames_.pop_back();
+      DISPATCH();
+    }
+
+    OP(box, "rr")
+    {
+      auto* cell = new value[1]{R(2)};
+      R(1).p = cell;
+      pc += SIZE("rr");
+      DISPATCH();
+    }
+    OP(load, "rr")
+    {
+      R(1) = *R(2).p;
+      pc += SIZE("rr");
+      DISPATCH();
+    }
+    OP(store, "rr")
+    {
+      *R(1).p = R(2);
+      pc += SIZE("rr");
+      DISPATCH();
+    }
+
+    OP(record, "ri")
+    {
+      R(1).p = new value[pc[2]];
+      pc += SIZE("ri");
+      DISPATCH();
+    }
+    OP(getf, "rri")
+    {
+      const value* record = R(2).p;
+      if (!record)
+        tc_runtime_failure("nil record dereference");
+      R(1) = record[pc[3]];
+      pc += SIZE("rri");
+      DISPATCH();
+    }
+    OP(setf, "rir")
+    {
+      value* record = R(1).p;
+      if (!record)
+        tc_runtime_failure("nil record dereference");
+      record[pc[2]] = R(3);
+      pc += SIZE("rir");
+      DISPATCH();
+    }
+
+    OP(array, "rrr")
+    {
+      const std::int32_t size = R(2).i;
+      const value init = R(3);
+      auto* array = new value[size < 0 ? 0 : size];
+      for (std::int32_t i = 0; i < size; ++i)
+        array[i] = init;
+      R(1).p = array;
+      pc += SIZE("rrr");
+      DISPATCH();
+    }
+    OP(geti, "rrr")
+    {
+      R(1) = R(2).p[R(3).i];
+      pc += SIZE("rrr");
+      DISPATCH();
+    }
+    OP(seti, "rrr")
+    {
+      R(1).p[R(2).i] = R(3);
+      pc += SIZE("rrr");
+      DISPATCH();
+    }
+
+#if !BYTECODE_COMPUTED_GOTO
+        }
+#endif
+
+#undef SIZE
+#undef OP
+#undef DISPATCH
+#undef R
+  }
+
+} // namespace bytecode
@@ -0,0 +1,59 @@
+/**
+ ** \file bytecode/vm.hh
+ ** \brief Declaration of bytecode::Vm.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <bytecode/fwd.hh>
+#include <bytecode/program.hh>
+#include <interpret/value.hh>
+
+namespace bytecode
+{
+  /** \brief The virtual machine running the bytecode.
+   **
+   ** The frames of the functions are windows on a single stack of
+   ** values: the frame of a callee starts at the arguments its caller
+   ** prepared in its own frame.  Primitives are run by the runtime
+   ** embedded in tc.
+   **
+   ** With GCC and Clang, the instructions are dispatched by computed
+   ** gotos, each instruction jumping directly to the next one;
+   ** otherwise, by a switch in a loop.
+   **/
+  class Vm
+  {
+  public:
+    /// Run \a program with a stack of \a stack_size values.
+    explicit Vm(const Program& program, std::size_t stack_size = 1 << 20);
+
+    /// Run the program, i.e., call its _main function.
+    void operator()();
+
+  private:
+    /// The return address of a call.
+    struct frame
+    {
+      /// The instruction after the call.
+      const word* pc;
+      /// The frame of the caller.
+      value* base;
+      /// The register of the caller receiving the result.
+      word dst;
+    };
+
+    /// Run the instructions from \a pc, with the frame \a base.
+    void run(const word* pc, value* base);
+
+    const Program& program_;
+    /// The constant pool, as runtime strings.
+    std::vector<const char*> constants_;
+    std::vector<value> stack_;
+    std::vector<frame> frames_;
+  };
+
+} // namespace bytecode
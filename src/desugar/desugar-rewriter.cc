@@ -0,0 +1,193 @@
+/**
+ ** \file desugar/desugar-rewriter.cc
+ ** \brief Implementation of desugar::DesugarRewriter.
+ */
+
+#include <ast/all.hh>
+#include <desugar/desugar-rewriter.hh>
+#include <misc/contract.hh>
+#include <parse/tiger-factory.hh>
+#include <type/builtin-types.hh>
+
+namespace desugar
+{
+  using namespace parse;
+
+  namespace
+  {
+    /// Give the type \a type to \a e, and return it.
+    template <typename T> T* typed(T* e, const type::Type& type)
+    {
+      e->type_set(&type);
+      return e;
+    }
+
+    /// A use of the variable \a def.
+    ast::SimpleVar* use(const location& loc, ast::VarDec& def)
+    {
+      ast::SimpleVar* res = make_SimpleVar(loc, def.name_get());
+      res->def_set(&def);
+      res->type_set(def.type_get());
+      return res;
+    }
+
+  } // namespace
+
+  DesugarRewriter::DesugarRewriter(bool desugar_for_p,
+                                   bool desugar_string_cmp_p)
+    : super_type()
+    , desugar_for_p_(desugar_for_p)
+    , desugar_string_cmp_p_(desugar_string_cmp_p)
+  {}
+
+  const misc::error& DesugarRewriter::error_get() const { return error_; }
+
+  ast::FunctionDec* DesugarRewriter::primitive(misc::symbol name,
+                                               const ast::Location& loc)
+  {
+    // Without the prelude, the primitive may not be declared: report it
+    // as the binder does for the desugared tree.
+    auto it = primitives_.find(name);
+    if (it == primitives_.end())
+      {
+        error_ << misc::error::error_type::bind << loc
+               << ": bind error, no fun " << name << " T T\n";
+        return nullptr;
+      }
+    return it->second;
+  }
+
+  void DesugarRewriter::operator()(ast::FunctionDec& e)
+  {
+    if (!e.body_get())
+      primitives_[e.name_get()] = &e;
+    super_type::operator()(e);
+  }
+
+  /*-----------------------------.
+  | Desugar string comparisons.  |
+  `-----------------------------*/
+
+  void DesugarRewriter::operator()(ast::OpExp& e)
+  {
+    super_type::operator()(e);
+    if (!desugar_string_cmp_p_
+        || *e.left_get().type_get() != type::String::instance()
+        || *e.right_get().type_get() != type::String::instance())
+      return;
+
+    const ast::OpExp::Oper oper = e.oper_get();
+    const bool equality =
+      oper == ast::OpExp::Oper::eq || oper == ast::OpExp::Oper::ne;
+    const misc::symbol name = equality ? "streq" : "strcmp";
+
+    const location& loc = e.location_get();
+    ast::FunctionDec* def = primitive(name, loc);
+    if (!def)
+      return;
+
+    const type::Type& int_type = type::Int::instance();
+    ast::CallExp* call = typed(
+      make_CallExp(loc, name,
+                   make_exps_type(&e.left_get(), &e.right_get())),
+      int_type);
+    call->def_set(def);
+    e.left_set(nullptr);
+    e.right_set(nullptr);
+
+    if (oper == ast::OpExp::Oper::eq)
+      // streq(left, right)
+      replace(call);
+    else
+      // streq(left, right) = 0, or strcmp(left, right) <op> 0
+      replace(typed(make_OpExp(loc, call,
+                               equality ? ast::OpExp::Oper::eq : oper,
+                               typed(make_IntExp(loc, 0), int_type)),
+                    int_type));
+  }
+
+  /*----------------------.
+  | Desugar `for' loops.  |
+  `----------------------*/
+
+  void DesugarRewriter::operator()(ast::BreakExp& e)
+  {
+    if (auto loop = dynamic_cast<const ast::ForExp*>(e.def_get()))
+      breaks_[loop].push_back(&e);
+  }
+
+  // See DesugarVisitor::operator()(const ast::ForExp&) for the
+  // translation.  The loop index keeps its declaration, so that its
+  // uses in the body remain bound.
+  void DesugarRewriter::operator()(ast::ForExp& e)
+  {
+    super_type::operator()(e);
+    if (!desugar_for_p_)
+      {
+        breaks_.erase(&e);
+        return;
+      }
+
+    const location& loc = e.location_get();
+    const type::Type& int_type = type::Int::instance();
+    const type::Type& void_type = type::Void::instance();
+
+    ast::VarDec& i = e.vardec_get();
+    ast::Exp& body = e.body_get();
+    ast::VarDec* lo = typed(
+      make_VarDec(loc, "_lo", nullptr, i.init_get()), int_type);
+    ast::VarDec* hi = typed(
+      make_VarDec(loc, "_hi", nullptr, &e.hi_get()), int_type);
+    e.vardec_set(nullptr);
+    e.hi_set(nullptr);
+    e.body_set(nullptr);
+    i.init_set(use(loc, *lo));
+    i.read_only_set(false);
+
+    // while 1 do (body; if i = _hi then break; i := i + 1)
+    ast::WhileExp* loop =
+      typed(make_WhileExp(loc, typed(make_IntExp(loc, 1), int_type),
+                          nullptr),
+            void_type);
+    ast::BreakExp* exit = typed(make_BreakExp(loc), void_type);
+    exit->def_set(loop);
+    for (ast::BreakExp* b : breaks_[&e])
+      b->def_set(loop);
+    breaks_.erase(&e);
+
+    ast::IfExp* last = typed(
+      make_IfExp(loc,
+                 typed(make_OpExp(loc, use(loc, i), ast::OpExp::Oper::eq,
+                                  use(loc, *hi)),
+                       int_type),
+                 exit, typed(make_SeqExp(loc, make_exps_type()), void_type)),
+      void_type);
+    ast::AssignExp* incr = typed(
+      make_AssignExp(loc, use(loc, i),
+                     typed(make_OpExp(loc, use(loc, i),
+                                      ast::OpExp::Oper::add,
+                                      typed(make_IntExp(loc, 1), int_type)),
+                           int_type)),
+      void_type);
+    loop->body_set(
+      typed(make_SeqExp(loc, make_exps_type(&body, last, incr)), void_type));
+
+    // if _lo <= _hi then loop
+    ast::IfExp* guard = typed(
+      make_IfExp(loc,
+                 typed(make_OpExp(loc, use(loc, *lo), ast::OpExp::Oper::le,
+                                  use(loc, *hi)),
+                       int_type),
+                 loop, typed(make_SeqExp(loc, make_exps_type()), void_type)),
+      void_type);
+
+    replace(typed(
+      make_LetExp(loc,
+                  make_ChunkList(loc, make_VarChunk(loc, lo),
+                                 make_VarChunk(loc, hi),
+                                 make_VarChunk(loc, &i)),
+                  typed(make_SeqExp(loc, make_exps_type(guard)), void_type)),
+      void_type));
+  }
+
+} // namespace desugar
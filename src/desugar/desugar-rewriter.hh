@@ -0,0 +1,70 @@
+/**
+ ** \file desugar/desugar-rewriter.hh
+ ** \brief Declaration of desugar::DesugarRewriter.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <ast/rewriter.hh>
+#include <misc/error.hh>
+#include <misc/symbol.hh>
+
+namespace desugar
+{
+  /** \brief Desugar some syntactic structures in place.
+
+      Perform the same rewriting as desugar::DesugarVisitor, but on
+      the AST itself instead of a copy of it.  The nodes that are
+      built are bound and typed on the fly, so the AST does not have
+      to be bound nor type-checked again.  */
+  class DesugarRewriter : public ast::Rewriter
+  {
+  public:
+    /// Superclass.
+    using super_type = ast::Rewriter;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Build a DesugarRewriter.
+    DesugarRewriter(bool desugar_for_p, bool desugar_string_cmp_p);
+
+    /// \name Visit methods.
+    /// \{
+    /// Desugar string comparisons.
+    void operator()(ast::OpExp& e) override;
+    /// Desugar `for' loops as `while' loops.
+    void operator()(ast::ForExp& e) override;
+    /// Record the `break's of the `for' loops.
+    void operator()(ast::BreakExp& e) override;
+    /// Record the primitives.
+    void operator()(ast::FunctionDec& e) override;
+    /// \}
+
+    /// The errors, e.g., the primitives used but not declared.
+    const misc::error& error_get() const;
+
+  private:
+    /// The primitive named \a name, used at \a loc.  Report a bind
+    /// error and return nullptr if it is not declared.
+    ast::FunctionDec* primitive(misc::symbol name, const ast::Location& loc);
+
+    /// Desugar `for' loops?
+    bool desugar_for_p_;
+    /// Desugar string comparisons?
+    bool desugar_string_cmp_p_;
+
+    /// The errors.
+    misc::error error_;
+    /// The primitives seen so far, by name.
+    std::unordered_map<misc::symbol, ast::FunctionDec*> primitives_;
+    /// The `break's of each `for' loop being desugared, to be bound to
+    /// the `while' loop that replaces it.
+    std::unordered_map<const ast::ForExp*, std::vector<ast::BreakExp*>>
+      breaks_;
+  };
+
+} // namespace desugar
@@ -8,8 +8,7 @@
 #include <desugar/desugar-visitor.hh>
 #include <misc/algorithm.hh>
 #include <misc/symbol.hh>
-#include <parse/libparse.hh>
-#include <parse/tweast.hh>
+#include <parse/tiger-factory.hh>
 
 namespace desugar
 {
@@ -38,51 +37,37 @@ namespace desugar
         return;
       }
 
+    const parse::location& loc = e.location_get();
     if (e.oper_get() == ast::OpExp::Oper::eq)
       {
-        const auto& left = recurse(e.left_get());
-        const auto& right = recurse(e.right_get());
-
-        parse::Tweast tweast;
-
-        tweast << "streq(" << left << ", " << right << ")";
-
-        ast::Exp* res = parse::parse(tweast);
-        result_ = res;
+        // streq(left, right)
+        result_ = parse::make_CallExp(
+          loc, "streq",
+          parse::make_exps_type(recurse(e.left_get()),
+                                recurse(e.right_get())));
+      }
+    else if (e.oper_get() == ast::OpExp::Oper::ne)
+      {
+        // streq(left, right) = 0
+        ast::CallExp* eq = parse::make_CallExp(
+          loc, "streq",
+          parse::make_exps_type(recurse(e.left_get()),
+                                recurse(e.right_get())));
+        result_ = parse::make_OpExp(loc, eq, ast::OpExp::Oper::eq,
+                                    parse::make_IntExp(loc, 0));
       }
     else if (e.oper_get() == ast::OpExp::Oper::le
              || e.oper_get() == ast::OpExp::Oper::lt
              || e.oper_get() == ast::OpExp::Oper::ge
              || e.oper_get() == ast::OpExp::Oper::gt)
       {
-        const auto& left = recurse(e.left_get());
-        const auto& right = recurse(e.right_get());
-        std::string comparator;
-
-        if (e.oper_get() == ast::OpExp::Oper::le)
-          {
-            comparator = "<=";
-          }
-        else if (e.oper_get() == ast::OpExp::Oper::lt)
-          {
-            comparator = "<";
-          }
-        else if (e.oper_get() == ast::OpExp::Oper::ge)
-          {
-            comparator = ">=";
-          }
-        else
-          {
-            comparator = ">";
-          }
-
-        parse::Tweast tweast;
-
-        tweast << "strcmp(" << left << ", " << right << ") " << comparator
-               << " 0";
-
-        ast::Exp* res = parse::parse(tweast);
-        result_ = res;
+        // strcmp(left, right) <op> 0
+        ast::CallExp* cmp = parse::make_CallExp(
+          loc, "strcmp",
+          parse::make_exps_type(recurse(e.left_get()),
+                                recurse(e.right_get())));
+        result_ = parse::make_OpExp(loc, cmp, e.oper_get(),
+                                    parse::make_IntExp(loc, 0));
       }
     else
       {
@@ -139,29 +124,46 @@ namespace desugar
       }
     else
       {
-        const auto& hi = recurse(e.hi_get());
-        const auto& body = recurse(e.body_get());
-        const auto& exp = recurse(e.vardec_get());
-        auto name = e.vardec_get().name_get();
-        const auto intexp = dynamic_cast<const ast::IntExp*>(exp->init_get());
-
-        parse::Tweast tweast;
-
-        tweast << "let" << '\n'
-               << "var _lo := " << intexp->value_get() << '\n'
-               << "var _hi := " << *hi << '\n'
-               << "var " << e.vardec_get().name_get() << " := _lo" << '\n'
-               << "in" << '\n'
-               << "if _lo <= _hi then" << '\n'
-               << "while 1 do" << '\n'
-               << "( " << *body << ";" << '\n'
-               << "if " << name << " = _hi then" << '\n'
-               << "break; " << name << " := " << name << " + 1" << '\n'
-               << ")" << '\n'
-               << "end" << '\n';
-
-        ast::Exp* res = parse::parse(tweast);
-        result_ = res;
+        using namespace parse;
+        const location& loc = e.location_get();
+        const misc::symbol lo("_lo");
+        const misc::symbol hi("_hi");
+        const misc::symbol i = e.vardec_get().name_get();
+
+        // ( body; if i = _hi then break; i := i + 1 )
+        ast::Exp* step = make_SeqExp(
+          loc,
+          make_exps_type(
+            recurse(e.body_get()),
+            make_IfExp(loc,
+                       make_OpExp(loc, make_SimpleVar(loc, i),
+                                  ast::OpExp::Oper::eq,
+                                  make_SimpleVar(loc, hi)),
+                       make_BreakExp(loc)),
+            make_AssignExp(loc, make_SimpleVar(loc, i),
+                           make_OpExp(loc, make_SimpleVar(loc, i),
+                                      ast::OpExp::Oper::add,
+                                      make_IntExp(loc, 1)))));
+
+        // if _lo <= _hi then while 1 do step
+        ast::Exp* loop = make_IfExp(
+          loc,
+          make_OpExp(loc, make_SimpleVar(loc, lo), ast::OpExp::Oper::le,
+                     make_SimpleVar(loc, hi)),
+          make_WhileExp(loc, make_IntExp(loc, 1), step));
+
+        ast::ChunkList* decs = make_ChunkList(
+          loc,
+          make_VarChunk(loc,
+                        make_VarDec(loc, lo, nullptr,
+                                    recurse(e.vardec_get().init_get()))),
+          make_VarChunk(loc,
+                        make_VarDec(loc, hi, nullptr, recurse(e.hi_get()))),
+          make_VarChunk(loc,
+                        make_VarDec(loc, i, nullptr, make_SimpleVar(loc, lo))));
+
+        result_ = make_LetExp(loc, decs,
+                              make_SeqExp(loc, make_exps_type(loop)));
       }
   }
 } // namespace desugar
@@ -35,6 +35,24 @@ namespace desugar
   template <typename A>
   A* desugar(const A& tree, bool desugar_for_p, bool desugar_string_cmp_p);
 
+  /** \brief Remove the syntactic sugar from an AST, in place.
+
+      This function performs the same rewriting as desugar::desugar,
+      but neither copies \a tree nor recomputes its bindings and types:
+      only the nodes that are built are bound and typed.
+
+      \param tree                 abstract syntax tree's root, whose bindings
+                                  and types have been computed, and whose
+                                  identifiers are all unique.
+      \param desugar_for_p        desugar `for' loops.
+      \param desugar_string_cmp_p desugar string comparisons.
+
+      \return the errors, e.g., a bind error if the primitives the
+              string comparisons are desugared into are not declared.  */
+  template <typename A>
+  misc::error
+  desugar_in_place(A& tree, bool desugar_for_p, bool desugar_string_cmp_p);
+
   /** \brief Remove the syntactic sugar from an AST without
       recomputing its bindings nor its types.
 
@@ -11,6 +11,7 @@
 #include <ast/exp.hh>
 #include <bind/libbind.hh>
 #include <desugar/bounds-checking-visitor.hh>
+#include <desugar/desugar-rewriter.hh>
 #include <desugar/desugar-visitor.hh>
 #include <desugar/libdesugar.hh>
 #include <escapes/libescapes.hh>
@@ -61,9 +62,19 @@ namespace desugar
     return desugared_ptr.release();
   }
 
+  template <typename A>
+  misc::error
+  desugar_in_place(A& tree, bool desugar_for_p, bool desugar_string_cmp_p)
+  {
+    DesugarRewriter desugar(desugar_for_p, desugar_string_cmp_p);
+    tree.accept(desugar);
+    return desugar.error_get();
+  }
+
   /// Explicit instantiations.
   template ast::ChunkList* raw_desugar(const ast::ChunkList&, bool, bool);
   template ast::ChunkList* desugar(const ast::ChunkList&, bool, bool);
+  template misc::error desugar_in_place(ast::ChunkList&, bool, bool);
 
   /*-----------------------.
   | Array bounds checking.  |
@@ -19,8 +19,10 @@ namespace desugar::tasks
 
   void desugar()
   {
-    astclone::apply(::desugar::desugar, ast::tasks::the_program, desugar_for_p,
-                    desugar_string_cmp_p);
+    task_error() << ::desugar::desugar_in_place(*ast::tasks::the_program,
+                                                desugar_for_p,
+                                                desugar_string_cmp_p)
+                 << &misc::error::exit_on_error;
     /// Escape after desugaring if escape was done before
     if (escapes::escaped)
       escapes::escapes_compute(*ast::tasks::the_program);
@@ -0,0 +1,51 @@
+/**
+ ** Checking in place desugaring.
+ */
+
+#include <ostream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <desugar/libdesugar.hh>
+#include <misc/contract.hh>
+#include <misc/error.hh>
+#include <misc/file-library.hh>
+#include <parse/libparse.hh>
+
+using namespace ast;
+using namespace desugar;
+
+const char* program_name = "test-desugar-rewriter";
+
+int main()
+{
+  ChunkList* tree =
+    parse::parse_unit("let primitive streq(s1 : string, s2 : string) : int\n"
+                      "    primitive strcmp(s1 : string, s2 : string) : int\n"
+                      "in\n"
+                      "  for i := 0 to 42 do\n"
+                      "    for j := i to 51 do\n"
+                      "      if \"foo\" <> \"bar\" & \"foo\" < \"baz\"\n"
+                      "        then (i; j; ())\n"
+                      "        else break\n"
+                      "end\n");
+  bind_and_types_check(*tree);
+
+  std::cout << "/* === Original tree...  */\n" << *tree << '\n';
+
+  // The desugared tree is bound and typed: binding and type-checking
+  // it again must succeed.
+  desugar_in_place(*tree, true, true);
+  bind_and_types_check(*tree);
+  std::cout << "/* === Desugared tree...  */\n" << *tree << '\n';
+  delete tree;
+
+  // Without the primitives, a string comparison is a bind error.
+  ChunkList* unbound = parse::parse_unit("let in \"foo\" = \"bar\" end\n");
+  bind_and_types_check(*unbound);
+  misc::error e = desugar_in_place(*unbound, true, true);
+  assertion(e);
+  std::cout << "/* === Without streq...  */\n" << e;
+  delete unbound;
+}
@@ -8,8 +8,7 @@
 #include <ranges>
 #include <callgraph/libcallgraph.hh>
 #include <inlining/inliner.hh>
-#include <parse/libparse.hh>
-#include <parse/tweast.hh>
+#include <parse/tiger-factory.hh>
 
 namespace inlining
 {
@@ -69,34 +68,42 @@ namespace inlining
       }
     else
       {
-        parse::Tweast tweast;
+        // let
+        //   var formal_1 : type_1 := arg_1
+        //   ...
+        //   var res : result := (body)
+        // in
+        //   res
+        // end
+        const parse::location& loc = e.location_get();
+        const FunctionDec& def = *e.def_get();
+        ChunkList* decs = parse::make_ChunkList(loc);
 
-        tweast << "let" << '\n';
-
-        VarChunk* dec = recurse(e.def_get()->formals_get());
-        for (size_t i = 0; i < dec->decs_get().size(); i++)
+        const VarChunk& formals = def.formals_get();
+        for (size_t i = 0; i < formals.decs_get().size(); i++)
           {
-            Exp* exp = recurse(*e.args_get()[i]);
-            misc::symbol name = dec->decs_get()[i]->name_get();
-            misc::symbol type_name =
-              dec->decs_get()[i]->type_name_get()->name_get();
-            tweast << "var " << name << " : " << type_name << " := " << exp
-                   << '\n';
+            const VarDec& formal = *formals[i];
+            decs->emplace_back(parse::make_VarChunk(
+              loc,
+              parse::make_VarDec(
+                loc, formal.name_get(),
+                parse::make_NameTy(loc, formal.type_name_get()->name_get()),
+                recurse(*e.args_get()[i]))));
           }
 
-        Exp* body = recurse(e.def_get()->body_get());
-        tweast << "var res";
-        if (e.def_get()->result_get() != nullptr)
-          {
-            misc::symbol result_type = e.def_get()->result_get()->name_get();
-            tweast << " : " << result_type;
-          }
-        tweast << " := (" << body << ")\n"
-               << "in" << '\n'
-               << "res" << '\n'
-               << "end\n";
-        ast::Exp* res = parse::parse(tweast);
-        result_ = res;
+        const misc::symbol res("res");
+        NameTy* result = def.result_get()
+          ? parse::make_NameTy(loc, def.result_get()->name_get())
+          : nullptr;
+        Exp* body = parse::make_SeqExp(
+          loc, parse::make_exps_type(recurse(def.body_get())));
+        decs->emplace_back(parse::make_VarChunk(
+          loc, parse::make_VarDec(loc, res, result, body)));
+
+        result_ = parse::make_LetExp(
+          loc, decs,
+          parse::make_SeqExp(
+            loc, parse::make_exps_type(parse::make_SimpleVar(loc, res))));
       }
   }
 
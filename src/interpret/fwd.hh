@@ -0,0 +1,24 @@
+/**
+ ** \file interpret/fwd.hh
+ ** \brief Forward declarations for the interpret module.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace interpret
+{
+  // From value.hh.
+  union value;
+
+  // From primitive.hh.
+  enum class primitive : std::int32_t;
+
+  // From interpreter.hh.
+  class Interpreter;
+
+  // From tier.hh.
+  class Tier;
+
+} // namespace interpret
@@ -0,0 +1,427 @@
+/**
+ ** \file interpret/interpreter.cc
+ ** \brief Implementation of interpret::Interpreter.
+ */
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <ast/all.hh>
+#include <interpret/interpreter.hh>
+#include <llvmtranslate/tiger-runtime.h>
+#include <misc/contract.hh>
+#include <type/types.hh>
+
+namespace interpret
+{
+  namespace
+  {
+    /// Whether values of type \a t are strings.
+    bool is_string(const type::Type& t)
+    {
+      return dynamic_cast<const type::String*>(&t.actual());
+    }
+
+    /// Collect the parent functions and the primitives of a program.
+    class ProfileCollector
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      /// The parent function of each function.
+      std::unordered_map<const ast::FunctionDec*, const ast::FunctionDec*>
+        parents;
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        parents[&e] = current_;
+        const ast::FunctionDec* previous = current_;
+        current_ = &e;
+        super_type::operator()(e);
+        current_ = previous;
+      }
+
+    private:
+      const ast::FunctionDec* current_ = nullptr;
+    };
+
+  } // namespace
+
+  Interpreter::Interpreter(Tier& tier, unsigned threshold)
+    : tier_(tier)
+    , threshold_(threshold)
+  {}
+
+  void Interpreter::profiles_compute(const ast::ChunkList& program)
+  {
+    ProfileCollector collect;
+    collect(program);
+    for (const auto& [f, parent] : collect.parents)
+      {
+        profile& p = profiles_[f];
+        p.parent = parent;
+        if (!f->body_get())
+          {
+            primitive prim;
+            if (primitive_find(f->name_get().get().c_str(), prim))
+              p.prim = prim;
+            else
+              error_ << misc::error::error_type::failure << f->location_get()
+                     << ": unsupported primitive " << f->name_get() << '\n';
+          }
+      }
+  }
+
+  void Interpreter::operator()(const ast::ChunkList& program)
+  {
+    profiles_compute(program);
+    if (error_)
+      return;
+
+    const ast::FunctionDec* main = nullptr;
+    for (const auto& [f, p] : profiles_)
+      if (f->name_get() == "_main")
+        main = f;
+    precondition(main);
+
+    tc_runtime_init();
+    std::vector<value> args;
+    call(*main, profiles_[main], args);
+    // As exit would do at the end of a compiled program.
+    tc_flush();
+  }
+
+  /*---------------------.
+  | Calls and profiles.  |
+  `---------------------*/
+
+  void Interpreter::heat(profile& p)
+  {
+    if (p.heat < threshold_)
+      ++p.heat;
+  }
+
+  value
+  Interpreter::call(const ast::FunctionDec& f, profile& p,
+                    std::vector<value>& args)
+  {
+    if (p.prim)
+      return primitive_call(*p.prim, args.data());
+
+    // Loops may have made F hot already: ask the tier once, at the
+    // first call at which F is hot.
+    heat(p);
+    if (threshold_ && p.heat == threshold_ && !p.tiered)
+      {
+        p.tiered = true;
+        p.entry = tier_.entry_get(f);
+      }
+    if (p.entry)
+      {
+        ++compiled_calls_;
+        value res = {.i = 0};
+        p.entry(args.data(), &res);
+        return res;
+      }
+
+    // The static link: the frame of the parent of F, found on the
+    // static chain of the caller.
+    frame* link = frame_;
+    while (link && link->function != p.parent)
+      link = link->link;
+
+    frame callee{&f, link, {}};
+    const ast::VarChunk& formals = f.formals_get();
+    callee.vars.reserve(formals.decs_get().size());
+    for (std::size_t i = 0; i < args.size(); ++i)
+      callee.vars.emplace_back(formals.decs_get()[i], args[i]);
+
+    frame* caller = frame_;
+    frame_ = &callee;
+    value res = eval(*f.body_get());
+    frame_ = caller;
+    return f.result_get() ? res : value{.i = 0};
+  }
+
+  void Interpreter::operator()(const ast::CallExp& e)
+  {
+    std::vector<value> args;
+    args.reserve(e.args_get().size());
+    for (const ast::Exp* arg : e.args_get())
+      args.push_back(eval(*arg));
+    const ast::FunctionDec& f = *e.def_get();
+    value_ = call(f, profiles_[&f], args);
+  }
+
+  /*-----------.
+  | Lvalues.  |
+  `-----------*/
+
+  value* Interpreter::location(const ast::VarDec& dec)
+  {
+    frame* f = frame_;
+    while (f->function != dec.def_site_get())
+      f = f->link;
+    // Look for the most recent declarations first.
+    for (auto it = f->vars.rbegin(); it != f->vars.rend(); ++it)
+      if (it->first == &dec)
+        return &it->second;
+    unreachable();
+  }
+
+  value* Interpreter::location(const ast::Var& e)
+  {
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e))
+      return location(*var->def_get());
+
+    if (auto var = dynamic_cast<const ast::FieldVar*>(&e))
+      {
+        value* record = eval(var->var_get()).p;
+        if (!record)
+          tc_runtime_failure("nil record dereference");
+        auto& type = static_cast<const type::Record&>(
+          var->var_get().type_get()->actual());
+        return record + type.field_index(var->name_get());
+      }
+
+    auto& var = static_cast<const ast::SubscriptVar&>(e);
+    value* array = eval(var.var_get()).p;
+    return array + eval(var.index_get()).i;
+  }
+
+  void Interpreter::operator()(const ast::SimpleVar& e)
+  {
+    value_ = *location(e);
+  }
+
+  void Interpreter::operator()(const ast::FieldVar& e)
+  {
+    value_ = *location(e);
+  }
+
+  void Interpreter::operator()(const ast::SubscriptVar& e)
+  {
+    value_ = *location(e);
+  }
+
+  /*--------------.
+  | Expressions.  |
+  `--------------*/
+
+  void Interpreter::operator()(const ast::NilExp&) { value_ = {.p = nullptr}; }
+
+  void Interpreter::operator()(const ast::IntExp& e)
+  {
+    value_ = {.i = e.value_get()};
+  }
+
+  void Interpreter::operator()(const ast::StringExp& e)
+  {
+    // The runtime strings are prefixed with their length.
+    auto [it, inserted] = strings_.try_emplace(&e, nullptr);
+    if (inserted)
+      it->second = tc_string(e.value_get().data(), e.value_get().size());
+    value_ = {.s = it->second};
+  }
+
+  void Interpreter::operator()(const ast::RecordExp& e)
+  {
+    auto& type = static_cast<const type::Record&>(e.type_get()->actual());
+    auto* record = new value[type.fields_get().size()];
+    for (const ast::FieldInit* field : e.fields_get())
+      record[type.field_index(field->name_get())] = eval(field->init_get());
+    value_ = {.p = record};
+  }
+
+  void Interpreter::operator()(const ast::ArrayExp& e)
+  {
+    const std::int32_t size = eval(e.size_get()).i;
+    const value init = eval(e.init_get());
+    auto* array = new value[size < 0 ? 0 : size];
+    for (std::int32_t i = 0; i < size; ++i)
+      array[i] = init;
+    value_ = {.p = array};
+  }
+
+  void Interpreter::operator()(const ast::OpExp& e)
+  {
+    using Oper = ast::OpExp::Oper;
+
+    const value left = eval(e.left_get());
+    const value right = eval(e.right_get());
+    const Oper oper = e.oper_get();
+
+    // Integers wrap around, as in compiled code.
+    auto wrap = [](std::uint32_t v) { return static_cast<std::int32_t>(v); };
+    const auto l = static_cast<std::uint32_t>(left.i);
+    const auto r = static_cast<std::uint32_t>(right.i);
+    switch (oper)
+      {
+      case Oper::add:
+        value_ = {.i = wrap(l + r)};
+        return;
+      case Oper::sub:
+        value_ = {.i = wrap(l - r)};
+        return;
+      case Oper::mul:
+        value_ = {.i = wrap(l * r)};
+        return;
+      case Oper::div:
+        if (!right.i)
+          tc_runtime_failure("division by zero");
+        value_ = {.i = right.i == -1 ? wrap(-l) : left.i / right.i};
+        return;
+      default:
+        break;
+      }
+
+    // Comparisons: strings by contents, records and arrays by address.
+    int cmp = 0;
+    const type::Type& type = *e.left_get().type_get();
+    if (is_string(type))
+      cmp = tc_strcmp(left.s, right.s);
+    else if (dynamic_cast<const type::Int*>(&type.actual()))
+      cmp = left.i < right.i ? -1 : left.i > right.i;
+    else
+      cmp = left.p != right.p;
+
+    bool res = false;
+    switch (oper)
+      {
+      case Oper::eq:
+        res = cmp == 0;
+        break;
+      case Oper::ne:
+        res = cmp != 0;
+        break;
+      case Oper::lt:
+        res = cmp < 0;
+        break;
+      case Oper::le:
+        res = cmp <= 0;
+        break;
+      case Oper::gt:
+        res = cmp > 0;
+        break;
+      case Oper::ge:
+        res = cmp >= 0;
+        break;
+      default:
+        unreachable();
+      }
+    value_ = {.i = res};
+  }
+
+  void Interpreter::operator()(const ast::SeqExp& e)
+  {
+    value_ = {.i = 0};
+    for (const ast::Exp* exp : e.exps_get())
+      exp->accept(*this);
+  }
+
+  void Interpreter::operator()(const ast::AssignExp& e)
+  {
+    // As the translator, evaluate the value first.
+    const value v = eval(e.exp_get());
+    *location(e.var_get()) = v;
+    value_ = {.i = 0};
+  }
+
+  void Interpreter::operator()(const ast::IfExp& e)
+  {
+    if (eval(e.test_get()).i)
+      e.thenclause_get().accept(*this);
+    else
+      e.elseclause_get().accept(*this);
+  }
+
+  void Interpreter::operator()(const ast::WhileExp& e)
+  {
+    profile& p = profiles_[frame_->function];
+    try
+      {
+        while (eval(e.test_get()).i)
+          {
+            e.body_get().accept(*this);
+            heat(p);
+          }
+      }
+    catch (const loop_exit&)
+      {}
+    value_ = {.i = 0};
+  }
+
+  void Interpreter::operator()(const ast::ForExp& e)
+  {
+    profile& p = profiles_[frame_->function];
+    const ast::VarDec& index = e.vardec_get();
+    index.accept(*this);
+    const std::int32_t hi = eval(e.hi_get()).i;
+    try
+      {
+        // Do not overflow when HI is the largest integer.
+        if (location(index)->i <= hi)
+          while (true)
+            {
+              e.body_get().accept(*this);
+              heat(p);
+              value* i = location(index);
+              if (i->i == hi)
+                break;
+              ++i->i;
+            }
+      }
+    catch (const loop_exit&)
+      {}
+    value_ = {.i = 0};
+  }
+
+  void Interpreter::operator()(const ast::BreakExp&) { throw loop_exit{}; }
+
+  void Interpreter::operator()(const ast::LetExp& e)
+  {
+    // Forget the variables of the let once it is evaluated, so that
+    // loops do not accumulate them, even when a break leaves it.
+    const std::size_t size = frame_->vars.size();
+    try
+      {
+        // Not operator()(const ast::ChunkList&), which runs a program.
+        super_type::operator()(e.chunks_get());
+        e.body_get().accept(*this);
+      }
+    catch (const loop_exit&)
+      {
+        frame_->vars.resize(size);
+        throw;
+      }
+    frame_->vars.resize(size);
+  }
+
+  void Interpreter::operator()(const ast::CastExp& e)
+  {
+    e.exp_get().accept(*this);
+  }
+
+  /*---------------.
+  | Declarations.  |
+  `---------------*/
+
+  void Interpreter::operator()(const ast::VarDec& e)
+  {
+    frame_->vars.emplace_back(&e, eval(*e.init_get()));
+  }
+
+  void Interpreter::operator()(const ast::FunctionChunk&)
+  {
+    // Functions are run when called.
+  }
+
+  void Interpreter::operator()(const ast::TypeChunk&)
+  {
+    // Nothing to run.
+  }
+
+} // namespace interpret
@@ -0,0 +1,154 @@
+/**
+ ** \file interpret/interpreter.hh
+ ** \brief Declaration of interpret::Interpreter.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/fwd.hh>
+#include <interpret/primitive.hh>
+#include <interpret/tier.hh>
+#include <interpret/value.hh>
+#include <misc/error.hh>
+
+namespace interpret
+{
+  /** \brief Evaluate a typed and desugared program, walking its AST.
+   **
+   ** Primitives are run by the runtime embedded in tc.  Each function
+   ** counts its calls and the iterations of its loops: once their sum
+   ** reaches the threshold, the function is handed to a Tier, and its
+   ** next calls run the compiled code instead.
+   **/
+  class Interpreter
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import overloaded operator() methods.
+    using super_type::operator();
+
+    /// Tier functions up to \a tier once they are \a threshold times
+    /// hot, never if \a threshold is 0.
+    Interpreter(Tier& tier, unsigned threshold);
+
+    /// Run \a program, i.e., call its _main function, unless it uses
+    /// primitives that tc does not provide.
+    void operator()(const ast::ChunkList& program) override;
+
+    /// Evaluate \a e.
+    value eval(const ast::Exp& e);
+
+    /// \name Lvalues
+    /// \{
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    /// \}
+
+    /// \name Expressions
+    /// \{
+    void operator()(const ast::NilExp&) override;
+    void operator()(const ast::IntExp& e) override;
+    void operator()(const ast::StringExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::BreakExp&) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::CastExp& e) override;
+    /// \}
+
+    /// \name Declarations
+    /// \{
+    void operator()(const ast::VarDec& e) override;
+    void operator()(const ast::FunctionChunk&) override;
+    void operator()(const ast::TypeChunk&) override;
+    /// \}
+
+    /// Number of calls run by compiled code.
+    std::size_t compiled_calls_get() const;
+
+    /// The errors, e.g., the primitives which are not supported.
+    const misc::error& error_get() const;
+
+  private:
+    /// What is known about a function.
+    struct profile
+    {
+      /// The function in which it is declared, if any.
+      const ast::FunctionDec* parent = nullptr;
+      /// The primitive it denotes, if it has no body.
+      std::optional<primitive> prim;
+      /// Number of calls and of loop iterations so far.
+      unsigned heat = 0;
+      /// Whether the tier was asked for it already.
+      bool tiered = false;
+      /// Its compiled code, if any.
+      Tier::entry_type entry = nullptr;
+    };
+
+    /// The activation of a function.
+    struct frame
+    {
+      const ast::FunctionDec* function;
+      /// The frame of the enclosing function (static link).
+      frame* link;
+      /// The variables of the function, in order of declaration.
+      std::vector<std::pair<const ast::VarDec*, value>> vars;
+    };
+
+    /// Thrown by BreakExp, caught by the enclosing loop.
+    struct loop_exit
+    {};
+
+    /// Record the functions of \a program in profiles_.
+    void profiles_compute(const ast::ChunkList& program);
+
+    /// The cell of a variable.
+    value* location(const ast::Var& e);
+    value* location(const ast::VarDec& dec);
+
+    /// Call \a f, compiled if it is hot enough.
+    value call(const ast::FunctionDec& f, profile& p, std::vector<value>& args);
+
+    /// Count a call or an iteration of \a p, up to the threshold.
+    void heat(profile& p);
+
+    /// The last value computed.
+    value value_ = {};
+
+    /// The frame of the running function.
+    frame* frame_ = nullptr;
+
+    Tier& tier_;
+    const unsigned threshold_;
+    std::size_t compiled_calls_ = 0;
+
+    /// The errors.
+    misc::error error_;
+
+    std::unordered_map<const ast::FunctionDec*, profile> profiles_;
+    /// The runtime string of each string literal.
+    std::unordered_map<const ast::StringExp*, const char*> strings_;
+  };
+
+} // namespace interpret
+
+#include <interpret/interpreter.hxx>
@@ -0,0 +1,25 @@
+/**
+ ** \file interpret/interpreter.hxx
+ ** \brief Inline methods of interpret::Interpreter.
+ */
+
+#pragma once
+
+#include <interpret/interpreter.hh>
+
+namespace interpret
+{
+  inline value Interpreter::eval(const ast::Exp& e)
+  {
+    e.accept(*this);
+    return value_;
+  }
+
+  inline std::size_t Interpreter::compiled_calls_get() const
+  {
+    return compiled_calls_;
+  }
+
+  inline const misc::error& Interpreter::error_get() const { return error_; }
+
+} // namespace interpret
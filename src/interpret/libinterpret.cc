@@ -0,0 +1,22 @@
+/**
+ ** \file interpret/libinterpret.cc
+ ** \brief Define exported interpret functions.
+ */
+
+#include <ast/chunk-list.hh>
+#include <interpret/interpreter.hh>
+#include <interpret/libinterpret.hh>
+#include <interpret/tier.hh>
+
+namespace interpret
+{
+  misc::error
+  run(const ast::ChunkList& program, unsigned threshold, unsigned level)
+  {
+    Tier tier{program, level};
+    Interpreter interpret{tier, threshold};
+    interpret(program);
+    return interpret.error_get();
+  }
+
+} // namespace interpret
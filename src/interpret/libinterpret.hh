@@ -0,0 +1,26 @@
+/**
+ ** \file interpret/libinterpret.hh
+ ** \brief Declare functions exported by the interpret module.
+ */
+
+#pragma once
+
+#include <ast/fwd.hh>
+#include <misc/error.hh>
+
+/// Running programs in tc.
+namespace interpret
+{
+  /** \brief Run \a program, typed, desugared and with its escapes
+   ** computed.
+   **
+   ** The program is interpreted, but for the functions called, or
+   ** looping, \a threshold times (never if 0): their next calls run
+   ** code compiled at \a level (0 to 3).
+   **
+   ** Nothing is run if \a program uses primitives that tc does not
+   ** provide: they are reported in the result.
+   **/
+  misc::error run(const ast::ChunkList& program, unsigned threshold, unsigned level);
+
+} // namespace interpret
@@ -0,0 +1,106 @@
+/**
+ ** \file interpret/primitive.cc
+ ** \brief Implementation of the primitives of the runtime embedded in tc.
+ */
+
+#include <cstring>
+#include <iterator>
+#include <ostream>
+
+#include <interpret/primitive.hh>
+#include <llvmtranslate/tiger-runtime.h>
+
+namespace interpret
+{
+  namespace
+  {
+    constexpr const char* primitives[] = {
+#define INTERPRET_PRIMITIVE(Name, TigerName) TigerName,
+      INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+    };
+
+    /// The value of the integer \a i, the rest of the word being null.
+    value integer(std::int32_t i)
+    {
+      value res;
+      res.p = nullptr;
+      res.i = i;
+      return res;
+    }
+
+  } // namespace
+
+  const char* name(primitive prim)
+  {
+    return primitives[static_cast<std::int32_t>(prim)];
+  }
+
+  bool primitive_find(const char* name, primitive& prim)
+  {
+    for (std::size_t i = 0; i < std::size(primitives); ++i)
+      if (!std::strcmp(primitives[i], name))
+        {
+          prim = static_cast<primitive>(i);
+          return true;
+        }
+    return false;
+  }
+
+  std::ostream& operator<<(std::ostream& ostr, primitive prim)
+  {
+    return ostr << name(prim);
+  }
+
+  value primitive_call(primitive prim, const value* args)
+  {
+    value res = integer(0);
+    switch (prim)
+      {
+      case primitive::print:
+        tc_print(args[0].s);
+        break;
+      case primitive::print_err:
+        tc_print_err(args[0].s);
+        break;
+      case primitive::print_int:
+        tc_print_int(args[0].i);
+        break;
+      case primitive::flush:
+        tc_flush();
+        break;
+      case primitive::getchar:
+        res.s = tc_getchar();
+        break;
+      case primitive::ord:
+        res = integer(tc_ord(args[0].s));
+        break;
+      case primitive::chr:
+        res.s = tc_chr(args[0].i);
+        break;
+      case primitive::size:
+        res = integer(tc_size(args[0].s));
+        break;
+      case primitive::streq:
+        res = integer(tc_streq(args[0].s, args[1].s));
+        break;
+      case primitive::strcmp:
+        res = integer(tc_strcmp(args[0].s, args[1].s));
+        break;
+      case primitive::substring:
+        res.s = tc_substring(args[0].s, args[1].i, args[2].i);
+        break;
+      case primitive::concat:
+        res.s = tc_concat(args[0].s, args[1].s);
+        break;
+      case primitive::not_:
+        res = integer(tc_not(args[0].i));
+        break;
+      case primitive::exit:
+        tc_exit(args[0].i);
+        break;
+      }
+    return res;
+  }
+
+} // namespace interpret
@@ -0,0 +1,51 @@
+/**
+ ** \file interpret/primitive.hh
+ ** \brief The primitives of the runtime embedded in tc.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+#include <interpret/value.hh>
+
+/// The primitives, as X(Name, Tiger name).
+#define INTERPRET_PRIMITIVES(X)                                                \
+  X(print, "print")                                                            \
+  X(print_err, "print_err")                                                    \
+  X(print_int, "print_int")                                                    \
+  X(flush, "flush")                                                            \
+  X(getchar, "getchar")                                                        \
+  X(ord, "ord")                                                                \
+  X(chr, "chr")                                                                \
+  X(size, "size")                                                              \
+  X(streq, "streq")                                                            \
+  X(strcmp, "strcmp")                                                          \
+  X(substring, "substring")                                                    \
+  X(concat, "concat")                                                          \
+  X(not_, "not")                                                               \
+  X(exit, "exit")
+
+namespace interpret
+{
+  /// The primitives of the prelude that tc runs itself, shared by the
+  /// interpreter and the bytecode virtual machine.
+  enum class primitive : std::int32_t
+  {
+#define INTERPRET_PRIMITIVE(Name, TigerName) Name,
+    INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+  };
+
+  /// The Tiger name of \a prim.
+  const char* name(primitive prim);
+  /// The primitive named \a name, if any.
+  bool primitive_find(const char* name, primitive& prim);
+
+  std::ostream& operator<<(std::ostream& ostr, primitive prim);
+
+  /// Call \a prim on the arguments \a args, with the runtime.
+  value primitive_call(primitive prim, const value* args);
+
+} // namespace interpret
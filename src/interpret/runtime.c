@@ -0,0 +1,7 @@
+/**
+   \file interpret/runtime.c
+   \brief The Tiger runtime, embedded in tc.
+*/
+
+#define TC_RUNTIME_EMBEDDED 1
+#include <llvmtranslate/tiger-runtime.c>
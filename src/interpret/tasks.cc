@@ -0,0 +1,25 @@
+/**
+ ** \file interpret/tasks.cc
+ ** \brief Interpret module related tasks' implementation.
+ */
+
+#include <ast/tasks.hh>
+#include <common.hh>
+#include <interpret/libinterpret.hh>
+#define DEFINE_TASKS 1
+#include <interpret/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace interpret::tasks
+{
+  int run_jit_threshold = 1000;
+  int run_jit_level = 2;
+
+  void run()
+  {
+    task_error() << ::interpret::run(*ast::tasks::the_program,
+                                     run_jit_threshold, run_jit_level)
+                 << &misc::error::exit_on_error;
+  }
+
+} // namespace interpret::tasks
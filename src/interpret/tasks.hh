@@ -0,0 +1,48 @@
+/**
+ ** \file interpret/tasks.hh
+ ** \brief Interpret module related tasks.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include <task/libtask.hh>
+
+/// Tasks of the interpret module.
+namespace interpret::tasks
+{
+  /// Number of calls and loop iterations after which a function is
+  /// compiled, 0 to never compile.
+  extern int run_jit_threshold;
+  /// The optimization level of compiled functions.
+  extern int run_jit_level;
+
+  TASK_GROUP("5.6. Execution");
+
+  /// Set the compilation threshold.
+  INT_TASK_DECLARE("run-jit-threshold",
+                   0,
+                   std::numeric_limits<int>::max(),
+                   "compile the functions called or looping NUM times "
+                   "(0 to interpret only), defaults to 1000",
+                   run_jit_threshold,
+                   "");
+
+  /// Set the optimization level of compiled functions.
+  INT_TASK_DECLARE("run-jit-level",
+                   0,
+                   3,
+                   "optimize compiled functions at level NUM (0 to 3), "
+                   "defaults to 2",
+                   run_jit_level,
+                   "");
+
+  /// Run the program.
+  TASK_DECLARE("run",
+               "run the program, interpreting it and compiling its hot "
+               "functions",
+               run,
+               "typed desugar-for desugar-string-cmp desugar escapes-compute");
+
+} // namespace interpret::tasks
@@ -0,0 +1,79 @@
+/**
+ ** Checking the interpreter, with and without its compiled tier.
+ */
+
+#include <iostream>
+
+#include <ast/all.hh>
+#include <interpret/interpreter.hh>
+#include <interpret/tier.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <parse/libparse.hh>
+
+using namespace ast;
+using namespace interpret;
+
+const char* program_name = "test-interpreter";
+
+namespace
+{
+  // Run TREE tiering functions up at THRESHOLD, and return the number
+  // of calls run by compiled code.
+  std::size_t run(const ChunkList& tree, unsigned threshold)
+  {
+    Tier tier{tree, 2};
+    Interpreter interpreter{tier, threshold};
+    interpreter(tree);
+    std::cout << std::flush;
+    return interpreter.compiled_calls_get();
+  }
+
+} // namespace
+
+int main()
+{
+  ChunkList* tree = parse::parse_unit(
+    "let primitive print(string : string)\n"
+    "    primitive print_int(int : int)\n"
+    "    primitive concat(fst : string, snd : string) : string\n"
+    "    type list = { head : int, tail : list }\n"
+    "    type ints = array of int\n"
+    "    function fib(n : int) : int =\n"
+    "      if n < 2 then n else fib(n - 1) + fib(n - 2)\n"
+    "    function twice(s : string) : string = concat(s, s)\n"
+    "    function sum(l : list) : int =\n"
+    "      if l = nil then 0 else l.head + sum(l.tail)\n"
+    "    var total := 0\n"
+    "    function add(n : int) = total := total + n\n"
+    "    var l : list := nil\n"
+    "    var a := ints [10] of 1\n"
+    "    var i := 0\n"
+    "in\n"
+    "  print_int(fib(15)); print(\"\\n\");\n"
+    "  print(twice(twice(\"ab\"))); print(\"\\n\");\n"
+    "  for j := 1 to 10 do (l := list { head = j, tail = l }; add(j));\n"
+    "  print_int(sum(l)); print(\" \"); print_int(total); print(\"\\n\");\n"
+    "  while 1 do (if i = 10 then break; a[i] := a[i] * i; i := i + 1);\n"
+    "  print_int(a[9]); print(\" \"); print_int(i); print(\"\\n\")\n"
+    "end\n");
+  llvmtranslate::prepare(*tree).ice_on_error_here();
+
+  // Interpreted only.
+  const std::size_t interpreted = run(*tree, 0);
+  // fib is compiled after a few calls, sum (a record argument) and
+  // add (an escaping variable) never are.
+  const std::size_t tiered = run(*tree, 5);
+  delete tree;
+
+  // A primitive that tc does not provide is reported, nothing is run.
+  ChunkList* unsupported =
+    parse::parse_unit("let primitive foo() in foo() end\n");
+  llvmtranslate::prepare(*unsupported).ice_on_error_here();
+  Tier tier{*unsupported, 2};
+  Interpreter interpreter{tier, 0};
+  interpreter(*unsupported);
+  const bool reported = interpreter.error_get();
+  delete unsupported;
+
+  return interpreted == 0 && tiered != 0 && reported ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/**
+ ** \file interpret/tier.cc
+ ** \brief Implementation of interpret::Tier.
+ */
+
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#pragma GCC diagnostic pop
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/tier.hh>
+#include <llvmtranslate/jit.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <llvmtranslate/tiger-runtime.h>
+#include <type/types.hh>
+
+namespace interpret
+{
+  namespace
+  {
+    /// The functions of a program that have a body, but _main.
+    class FunctionCollector
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        if (e.body_get() && e.name_get() != "_main")
+          functions.push_back(&e);
+        super_type::operator()(e);
+      }
+
+      std::vector<const ast::FunctionDec*> functions;
+    };
+
+    /// Whether values of type \a t are represented alike by the
+    /// interpreter and by compiled code.
+    bool shared(const type::Type& t)
+    {
+      const type::Type& actual = t.actual();
+      return dynamic_cast<const type::Int*>(&actual)
+        || dynamic_cast<const type::String*>(&actual);
+    }
+
+    /// The name of the entry point of \a f.
+    std::string entry_name(const ast::FunctionDec& f)
+    {
+      return "tc_tierup_" + f.name_get().get();
+    }
+
+    /// Add the entry point of \a f to \a module, if possible.
+    bool entry_add(llvm::Module& module, const ast::FunctionDec& f)
+    {
+      auto& type = static_cast<const type::Function&>(*f.type_get());
+      for (const type::Field& formal : type.formals_get())
+        if (!shared(formal.type_get()))
+          return false;
+      if (f.result_get() && !shared(type.result_get()))
+        return false;
+
+      // Escaping variables are given as extra arguments.
+      llvm::Function* callee = module.getFunction(f.name_get().get());
+      if (!callee || callee->arg_size() != f.formals_get().decs_get().size())
+        return false;
+
+      llvm::LLVMContext& ctx = module.getContext();
+      auto* value_ptr = llvm::Type::getInt8PtrTy(ctx);
+      auto* entry = llvm::Function::Create(
+        llvm::FunctionType::get(llvm::Type::getVoidTy(ctx),
+                                {value_ptr, value_ptr}, false),
+        llvm::Function::ExternalLinkage, entry_name(f), module);
+      llvm::IRBuilder<> builder{llvm::BasicBlock::Create(ctx, "entry", entry)};
+
+      // Values are unions: each argument lies at the beginning of its
+      // slot.
+      std::vector<llvm::Value*> args;
+      for (llvm::Argument& formal : callee->args())
+        {
+          auto* slot = builder.CreateConstGEP1_64(
+            builder.getInt8Ty(), entry->getArg(0),
+            formal.getArgNo() * sizeof(value));
+          args.push_back(builder.CreateLoad(
+            formal.getType(),
+            builder.CreateBitCast(slot, formal.getType()->getPointerTo())));
+        }
+      llvm::Value* result = builder.CreateCall(callee, args);
+      if (!result->getType()->isVoidTy())
+        builder.CreateStore(
+          result, builder.CreateBitCast(entry->getArg(1),
+                                        result->getType()->getPointerTo()));
+      builder.CreateRetVoid();
+      return true;
+    }
+
+  } // namespace
+
+  Tier::Tier(const ast::ChunkList& program, unsigned level)
+    : program_(program)
+    , level_(level)
+  {}
+
+  Tier::~Tier() = default;
+
+  void Tier::compile()
+  {
+    compiled_ = true;
+
+    // The JIT compiles for the host, which runs the interpreter.
+    auto [ctx, module] =
+      llvmtranslate::translate(program_, false, llvmtranslate::host_64());
+    FunctionCollector collect;
+    collect(program_);
+    for (const ast::FunctionDec* f : collect.functions)
+      if (entry_add(*module, *f))
+        entries_.insert(f);
+
+    jit_ = std::make_unique<llvmtranslate::Jit>();
+    // Share the runtime with the interpreter.
+#define DEFINE(Name) jit_->define(#Name, reinterpret_cast<void*>(&Name))
+    DEFINE(tc_alloc_cursor);
+    DEFINE(tc_alloc_limit);
+    DEFINE(tc_alloc);
+    DEFINE(tc_init_array);
+    DEFINE(tc_not);
+    DEFINE(tc_exit);
+    DEFINE(tc_chr);
+    DEFINE(tc_concat);
+    DEFINE(tc_ord);
+    DEFINE(tc_size);
+    DEFINE(tc_substring);
+    DEFINE(tc_strcmp);
+    DEFINE(tc_streq);
+    DEFINE(tc_getchar);
+    DEFINE(tc_print);
+    DEFINE(tc_print_err);
+    DEFINE(tc_print_int);
+    DEFINE(tc_flush);
+#undef DEFINE
+
+    // Compilation failures are not fatal: the interpreter goes on.
+    if (jit_->add(std::move(ctx), std::move(module), level_))
+      jit_.reset();
+  }
+
+  Tier::entry_type Tier::entry_get(const ast::FunctionDec& f)
+  {
+    if (!compiled_)
+      compile();
+    if (!jit_ || !entries_.contains(&f))
+      return nullptr;
+
+    misc::error error;
+    return reinterpret_cast<entry_type>(jit_->lookup(entry_name(f), error));
+  }
+
+} // namespace interpret
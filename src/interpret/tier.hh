@@ -0,0 +1,55 @@
+/**
+ ** \file interpret/tier.hh
+ ** \brief Declaration of interpret::Tier.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+
+#include <ast/fwd.hh>
+#include <interpret/value.hh>
+#include <llvmtranslate/fwd.hh>
+
+namespace interpret
+{
+  /** \brief The compiled tier of the interpreter.
+   **
+   ** The first time a function is requested, the whole program is
+   ** translated to LLVM IR, with an entry point for every function
+   ** whose arguments and result are integers or strings, and that is
+   ** not given escaping variables.  It is compiled by a JIT that
+   ** resolves the primitives to the runtime embedded in tc, so that
+   ** interpreted and compiled code share its state.
+   **/
+  class Tier
+  {
+  public:
+    /// An entry point: call the function with the arguments of
+    /// \a args, and store its result in \a result.
+    using entry_type = void (*)(const value* args, value* result);
+
+    /// Compile \a program, typed and desugared, at \a level (0 to 3).
+    Tier(const ast::ChunkList& program, unsigned level);
+    Tier(const Tier&) = delete;
+    Tier& operator=(const Tier&) = delete;
+    ~Tier();
+
+    /// The compiled code of \a f, or nullptr if it cannot be compiled.
+    entry_type entry_get(const ast::FunctionDec& f);
+
+  private:
+    /// Translate and compile the program.
+    void compile();
+
+    const ast::ChunkList& program_;
+    const unsigned level_;
+    /// Whether the program was compiled, or failed to.
+    bool compiled_ = false;
+    /// The functions with an entry point.
+    std::unordered_set<const ast::FunctionDec*> entries_;
+    std::unique_ptr<llvmtranslate::Jit> jit_;
+  };
+
+} // namespace interpret
@@ -0,0 +1,29 @@
+/**
+ ** \file interpret/value.hh
+ ** \brief Declaration of interpret::value.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace interpret
+{
+  /** \brief A Tiger value, as handled by the interpreter and by the
+   ** bytecode virtual machine.
+   **
+   ** The programs being typed, values carry no tag.  Integers and
+   ** strings are represented as in the runtime, so that they can be
+   ** given to its primitives and to compiled code as is.  Records,
+   ** arrays and the cells of escaping variables are vectors of values,
+   ** allocated on the heap and never freed, as in the runtime; nil is
+   ** the null pointer.
+   **/
+  union value
+  {
+    std::int32_t i;
+    const char* s;
+    value* p;
+  };
+
+} // namespace interpret
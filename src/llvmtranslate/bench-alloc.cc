@@ -0,0 +1,79 @@
+/**
+ ** \file llvmtranslate/bench-alloc.cc
+ ** \brief Measure the allocation of records by compiled programs.
+ **
+ ** Build with `make src/llvmtranslate/bench-alloc', run with an
+ ** optional number of records (10000000 by default), and an optional
+ ** optimization level (2 by default).
+ **
+ ** The program builds lists of 1000 records, and sums them.  It is run
+ ** by the JIT twice: allocating in the regions of the runtime, then in
+ ** the heap of its garbage collector (as with --gc).
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ast/chunk-list.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <misc/error.hh>
+#include <misc/timer.hh>
+#include <parse/libparse.hh>
+
+const char* program_name = "bench-alloc";
+
+// Build N records, in lists of 1000, and print N.
+static std::string program(int n)
+{
+  std::ostringstream o;
+  o << "let\n"
+    << "  primitive print_int(i : int)\n"
+    << "  type list = { hd : int, tl : list }\n"
+    << "  function build(n : int) : list =\n"
+    << "    let var l : list := nil\n"
+    << "    in for i := 1 to n do l := list { hd = 1, tl = l }; l end\n"
+    << "  function sum(l : list) : int =\n"
+    << "    if l = nil then 0 else l.hd + sum(l.tl)\n"
+    << "  var total := 0\n"
+    << "in\n"
+    << "  for i := 1 to " << n / 1000 << " do\n"
+    << "    total := total + sum(build(1000));\n"
+    << "  print_int(total)\n"
+    << "end\n";
+  return o.str();
+}
+
+int main(int argc, char* argv[])
+{
+  const int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+  const unsigned level = argc > 2 ? std::atoi(argv[2]) : 2;
+
+  std::unique_ptr<ast::ChunkList> tree{parse::parse_unit(program(n))};
+  misc::error e = llvmtranslate::prepare(*tree);
+  if (e)
+    {
+      std::cerr << e;
+      return EXIT_FAILURE;
+    }
+
+  misc::timer t;
+  t.start();
+  for (bool gc : {false, true})
+    {
+      const char* name = gc ? "gc" : "region";
+      t.push(name);
+      e << llvmtranslate::run(*tree, gc, level);
+      t.pop(name);
+      std::cout << '\n';
+    }
+  t.stop();
+
+  std::cout << n << " records\n";
+  t.dump(std::cout);
+  if (e)
+    std::cerr << e;
+  return e ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+/**
+ ** \file llvmtranslate/bench-concat.cc
+ ** \brief Measure the building of strings by concatenation.
+ **
+ ** Build with `make src/llvmtranslate/bench-concat', run with an
+ ** optional length (10000000 by default), and an optional optimization
+ ** level (2 by default).
+ **
+ ** The program builds a string one character at a time, with concat.
+ ** It is run by the JIT for a quarter, a half and the whole of the
+ ** length: the times should double from one to the next.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ast/chunk-list.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <misc/error.hh>
+#include <misc/timer.hh>
+#include <parse/libparse.hh>
+
+const char* program_name = "bench-concat";
+
+// Build a string of N characters, and print its size.
+static std::string program(int n)
+{
+  std::ostringstream o;
+  o << "let\n"
+    << "  primitive print_int(i : int)\n"
+    << "  primitive chr(code : int) : string\n"
+    << "  primitive concat(fst : string, snd : string) : string\n"
+    << "  primitive size(s : string) : int\n"
+    << "  var s := \"\"\n"
+    << "in\n"
+    << "  for i := 1 to " << n << " do\n"
+    << "    s := concat(s, chr(97 + i - i / 26 * 26));\n"
+    << "  print_int(size(s))\n"
+    << "end\n";
+  return o.str();
+}
+
+int main(int argc, char* argv[])
+{
+  const int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+  const unsigned level = argc > 2 ? std::atoi(argv[2]) : 2;
+
+  misc::error e;
+  misc::timer t;
+  t.start();
+  for (int length : {n / 4, n / 2, n})
+    {
+      std::unique_ptr<ast::ChunkList> tree{parse::parse_unit(program(length))};
+      e << llvmtranslate::prepare(*tree);
+      if (e)
+        {
+          std::cerr << e;
+          return EXIT_FAILURE;
+        }
+
+      const std::string name = std::to_string(length) + " characters";
+      t.push(name);
+      e << llvmtranslate::run(*tree, false, level);
+      t.pop(name);
+      std::cout << '\n';
+    }
+  t.stop();
+
+  t.dump(std::cout);
+  if (e)
+    std::cerr << e;
+  return e ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+/**
+ ** \file llvmtranslate/bench-ir-size.cc
+ ** \brief Measure the size of the LLVM IR translated from Tiger files.
+ **
+ ** Build with `make src/llvmtranslate/bench-ir-size', run with Tiger
+ ** files, e.g., those of tests/good.
+ **
+ ** Each file is translated as with --llvm-display, without optimization,
+ ** and its numbers of basic blocks and of instructions are reported,
+ ** then their totals.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+#include <llvm/IR/Module.h>
+
+#pragma GCC diagnostic pop
+
+#include <ast/chunk-list.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+#include <misc/error.hh>
+#include <misc/file-library.hh>
+#include <misc/timer.hh>
+#include <parse/libparse.hh>
+
+const char* program_name = "bench-ir-size";
+
+int main(int argc, char* argv[])
+{
+  unsigned total_blocks = 0;
+  unsigned total_instructions = 0;
+  misc::error e;
+
+  misc::timer t;
+  t.start();
+  for (int i = 1; i < argc; ++i)
+    {
+      misc::file_library library;
+      auto [chunks, error] =
+        parse::parse("builtin", argv[i], library, false, false);
+      std::unique_ptr<ast::ChunkList> tree{chunks};
+      misc::error file_error = error;
+      if (!file_error)
+        file_error << llvmtranslate::prepare(*tree);
+      if (file_error)
+        {
+          e << file_error;
+          continue;
+        }
+
+      t.push("translate");
+      auto [ctx, module] = llvmtranslate::translate(*tree);
+      t.pop("translate");
+
+      unsigned blocks = 0;
+      unsigned instructions = 0;
+      for (const llvm::Function& f : *module)
+        for (const llvm::BasicBlock& bb : f)
+          {
+            ++blocks;
+            instructions += bb.size();
+          }
+      std::cout << argv[i] << ": " << blocks << " blocks, " << instructions
+                << " instructions\n";
+      total_blocks += blocks;
+      total_instructions += instructions;
+
+      // The module belongs to its context.
+      module.reset();
+    }
+  t.stop();
+
+  std::cout << "total: " << total_blocks << " blocks, " << total_instructions
+            << " instructions\n";
+  t.dump(std::cout);
+  if (e)
+    std::cerr << e;
+  return e ? EXIT_FAILURE : EXIT_SUCCESS;
+}
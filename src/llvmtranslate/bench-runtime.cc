@@ -0,0 +1,74 @@
+/**
+ ** \file llvmtranslate/bench-runtime.cc
+ ** \brief Measure the primitives of the runtime on strings and arrays.
+ **
+ ** Build with `make src/llvmtranslate/bench-runtime', run with an
+ ** optional number of iterations (100000 by default), and an optional
+ ** size of the strings and arrays (4096 by default).
+ **
+ ** The primitives are those of the runtime embedded in tc, called
+ ** directly: this measures the runtime alone, not the compiled code
+ ** calling it.  The garbage collector is enabled, as with --gc, so that
+ ** the allocations fit in memory.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <llvmtranslate/tiger-runtime.h>
+#include <misc/timer.hh>
+
+const char* program_name = "bench-runtime";
+
+namespace
+{
+  /// Where the results go, so that the calls are not optimized away.
+  volatile long sink;
+
+  /// Time \a iterations calls to \a f under \a name.
+  template <typename F>
+  void measure(misc::timer& t, const std::string& name, int iterations, F f)
+  {
+    t.push(name);
+    long res = 0;
+    for (int i = 0; i < iterations; ++i)
+      res += f(i);
+    sink = res;
+    t.pop(name);
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const int size = argc > 2 ? std::atoi(argv[2]) : 4096;
+
+  tc_runtime_init();
+  tc_gc_init(__builtin_frame_address(0));
+  const std::string chars(size, 'a');
+  const char* a = tc_string(chars.data(), size);
+  const char* b = tc_string(chars.data(), size);
+  // Differs from `a' at the end only.
+  const char* c = tc_concat(tc_substring(a, 0, size - 1), tc_chr('b'));
+
+  misc::timer t;
+  t.start();
+  measure(t, "init_array", iterations, [size](int i) {
+    return static_cast<int*>(tc_init_array(size, sizeof(int), i))[size - 1];
+  });
+  measure(t, "concat", iterations,
+          [a, b](int) { return tc_size(tc_concat(a, b)); });
+  measure(t, "substring", iterations, [a, size](int i) {
+    return tc_size(tc_substring(a, i % 2, size - 1));
+  });
+  measure(t, "streq", iterations,
+          [a, b, c](int i) { return tc_streq(a, i % 2 ? b : c); });
+  measure(t, "strcmp", iterations,
+          [a, c](int i) { return tc_strcmp(i % 2 ? a : c, c); });
+  t.stop();
+
+  std::cout << iterations << " iterations on " << size << " elements\n";
+  t.dump(std::cout);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include <ast/fwd.hh>
 #include <misc/set.hh>
@@ -22,10 +23,23 @@ namespace llvm
 
 } // namespace llvm
 
+namespace llvm::orc
+{
+  // From llvm/ExecutionEngine/Orc/LLJIT.h
+  class LLJIT;
+
+} // namespace llvm::orc
+
 namespace llvmtranslate
 {
+  // From jit.hh.
+  class Jit;
+
   using escaped_map_type =
     std::map<const type::Function*, misc::set<const ast::VarDec*>>;
   using frame_map_type = escaped_map_type;
 
+  /// Function declarations, e.g., a partition of those of a program.
+  using function_decs_type = std::vector<const ast::FunctionDec*>;
+
 } // namespace llvmtranslate
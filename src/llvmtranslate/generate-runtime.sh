@@ -1,32 +1,55 @@
 #!/bin/sh
 
-[ -z "$1" ] && echo "$0: Missing input file" && exit
-[ -z "$2" ] && echo "$0: Missing output file" && exit
+[ -z "$1" ] && echo "$0: Missing 32-bit input file" && exit
+[ -z "$2" ] && echo "$0: Missing 64-bit input file" && exit
+[ -z "$3" ] && echo "$0: Missing output file" && exit
 
-input=$1
-output=$2
+input_32=$1
+input_64=$2
+output=$3
 
-awk 'BEGIN {
-      print("#include <string>");
-      print("#include <llvmtranslate/libllvmtranslate.hh>");
-      print("");
-      print("namespace llvmtranslate");
-      print("{");
-      print("const char* runtime_string()");
-      print("{");
-      print("  return");
-      printf("R\"(");
-    }
-    /^#(<<|>>)/ {
-      next;
-    }
-    {
-      print($0);
-    }
-    END {
-      print(")\";");
-      print("}");
-      print("} // namespace llvmtranslate");
-    }' "$input" > "$output".tmp
+# Embed the bitcode of $1 as the array of bytes $2, twelve per line.
+bitcode()
+{
+  od -An -v -tx1 "$1" |
+    awk -v name="$2" 'BEGIN {
+          print("    // The bitcode reader reads words.");
+          printf("    alignas(4) const unsigned char %s[] = {\n", name);
+        }
+        {
+          for (i = 1; i <= NF; ++i)
+            {
+              if (n % 12 == 0)
+                printf("      ");
+              printf("0x%s,", $i);
+              printf(++n % 12 == 0 ? "\n" : " ");
+            }
+        }
+        END {
+          if (n % 12 != 0)
+            print("");
+          print("    };");
+        }'
+}
+
+{
+  echo "#include <llvmtranslate/libllvmtranslate.hh>"
+  echo
+  echo "namespace llvmtranslate"
+  echo "{"
+  echo "  namespace"
+  echo "  {"
+  bitcode "$input_32" bitcode_32
+  bitcode "$input_64" bitcode_64
+  echo "  } // namespace"
+  echo
+  echo "  llvm::StringRef runtime_bitcode(bool target_64)"
+  echo "  {"
+  echo "    if (target_64)"
+  echo "      return {reinterpret_cast<const char*>(bitcode_64), sizeof bitcode_64};"
+  echo "    return {reinterpret_cast<const char*>(bitcode_32), sizeof bitcode_32};"
+  echo "  }"
+  echo "} // namespace llvmtranslate"
+} > "$output".tmp
 
 mv "$output".tmp "$output"
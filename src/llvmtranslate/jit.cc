@@ -0,0 +1,102 @@
+/**
+ ** \file llvmtranslate/jit.cc
+ ** \brief Implementation of llvmtranslate::Jit.
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wredundant-move"
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/TargetSelect.h>
+
+#pragma GCC diagnostic pop
+
+#include <common.hh> // program_name
+#include <llvmtranslate/jit.hh>
+#include <llvmtranslate/libllvmtranslate.hh>
+
+namespace llvmtranslate
+{
+  namespace
+  {
+    /// Report \a err on \a error.
+    misc::error& report(misc::error& error, llvm::Error err)
+    {
+      return error << misc::error::error_type::failure << program_name
+                   << ": " << llvm::toString(std::move(err)) << '\n';
+    }
+
+  } // namespace
+
+  Jit::Jit()
+  {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    // Failing to target the host is not a user error.
+    jit_ = llvm::cantFail(llvm::orc::LLJITBuilder().create());
+    jit_->getMainJITDylib().addGenerator(
+      llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::
+                       GetForCurrentProcess(
+                         jit_->getDataLayout().getGlobalPrefix())));
+  }
+
+  Jit::~Jit() = default;
+
+  void Jit::define(const std::string& name, void* address)
+  {
+    llvm::cantFail(jit_->getMainJITDylib().define(llvm::orc::absoluteSymbols(
+      {{jit_->mangleAndIntern(name),
+        llvm::JITEvaluatedSymbol::fromPointer(address)}})));
+  }
+
+  misc::error Jit::add(std::unique_ptr<llvm::LLVMContext> ctx,
+                       std::unique_ptr<llvm::Module> module,
+                       unsigned level,
+                       misc::timer* timer)
+  {
+    misc::error error;
+
+    // The sizes of the types are already folded in the IR: a module
+    // translated for another target cannot be run.
+    const llvm::Triple& host = jit_->getTargetTriple();
+    if (llvm::Triple(module->getTargetTriple()).getArch() != host.getArch())
+      {
+        error << misc::error::error_type::failure << program_name
+              << ": cannot run a module for " << module->getTargetTriple()
+              << " on " << host.str() << '\n';
+        // The module must be destroyed before its context.
+        module.reset();
+        return error;
+      }
+    if (module->getDataLayout().isDefault())
+      module->setDataLayout(jit_->getDataLayout());
+    if (level)
+      optimize(*module, level, timer);
+
+    if (auto err = jit_->addIRModule(
+          llvm::orc::ThreadSafeModule(std::move(module), std::move(ctx))))
+      report(error, std::move(err));
+    return error;
+  }
+
+  void* Jit::lookup(const std::string& name, misc::error& error)
+  {
+    auto symbol = jit_->lookup(name);
+    if (!symbol)
+      {
+        report(error, symbol.takeError());
+        return nullptr;
+      }
+    return reinterpret_cast<void*>(symbol->getAddress());
+  }
+
+} // namespace llvmtranslate
@@ -0,0 +1,49 @@
+/**
+ ** \file llvmtranslate/jit.hh
+ ** \brief Declaration of llvmtranslate::Jit.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <llvmtranslate/fwd.hh>
+#include <misc/error.hh>
+#include <misc/fwd.hh>
+
+namespace llvmtranslate
+{
+  /** \brief A JIT compiler for the host, running in the tc process.
+   **
+   ** Symbols that are neither defined by the added modules nor by
+   ** define() are looked up in the process, e.g., in the C library.
+   **/
+  class Jit
+  {
+  public:
+    Jit();
+    Jit(const Jit&) = delete;
+    Jit& operator=(const Jit&) = delete;
+    ~Jit();
+
+    /// Make the symbol \a name denote \a address in the compiled code.
+    void define(const std::string& name, void* address);
+
+    /// Optimize \a module, translated for the host, at \a level (0 to 3),
+    /// the passes being timed in \a timer if not null, and add it.
+    /// Report on the result if \a module targets another architecture.
+    misc::error add(std::unique_ptr<llvm::LLVMContext> ctx,
+                    std::unique_ptr<llvm::Module> module,
+                    unsigned level,
+                    misc::timer* timer = nullptr);
+
+    /// The address of the symbol \a name, compiling it if needed.
+    /// Return nullptr and report on \a error if it cannot be found.
+    void* lookup(const std::string& name, misc::error& error);
+
+  private:
+    std::unique_ptr<llvm::orc::LLJIT> jit_;
+  };
+
+} // namespace llvmtranslate
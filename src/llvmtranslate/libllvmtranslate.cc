@@ -3,20 +3,52 @@
  ** \brief Public llvmtranslate module interface implementation.
  **/
 
+#include <algorithm>
+#include <cstdio>
+
+#include <ast/all.hh>
 #include <ast/default-visitor.hh>
 #include <ast/non-object-visitor.hh>
+#include <bind/libbind.hh>
 #include <common.hh> // program_name
+#include <desugar/libdesugar.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <misc/timer.hh>
+#include <type/libtype.hh>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wuninitialized"
 
-#include <llvm/AsmParser/Parser.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/IR/PassManager.h>
 #include <llvm/IR/Verifier.h>
-#include <llvm/Support/SourceMgr.h> // llvm::SMDiagnostic
+#include <llvm/Linker/Linker.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/IPO/Internalize.h>
 #include <llvmtranslate/escapes-collector.hh>
 #include <llvmtranslate/fwd.hh>
+#include <llvmtranslate/jit.hh>
 #include <llvmtranslate/libllvmtranslate.hh>
 #include <llvmtranslate/translator.hh>
 
@@ -24,24 +56,425 @@
 
 namespace llvmtranslate
 {
-  std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>>
-  translate(const ast::Ast& the_program)
+  namespace
+  {
+    /// Make the host target available to code generation, once, even
+    /// when partitions are compiled in parallel.
+    void native_target_initialize()
+    {
+      static const bool initialized = [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        return true;
+      }();
+      (void)initialized;
+    }
+
+    /// The machine of \a triple, or null with the reason in \a message.
+    std::unique_ptr<llvm::TargetMachine>
+    target_machine(const std::string& triple, std::string& message)
+    {
+      native_target_initialize();
+      const llvm::Target* target =
+        llvm::TargetRegistry::lookupTarget(triple, message);
+      if (!target)
+        return nullptr;
+      // The runtime is built as position independent code, do the same.
+      return std::unique_ptr<llvm::TargetMachine>{target->createTargetMachine(
+        triple, "generic", "", llvm::TargetOptions(), llvm::Reloc::PIC_)};
+    }
+
+    /// The sizes of the types depend on the target: set the layout of
+    /// \a module before any optimization folds them.
+    void data_layout_set(llvm::Module& module)
+    {
+      std::string message;
+      if (auto machine = target_machine(module.getTargetTriple(), message))
+        module.setDataLayout(machine->createDataLayout());
+    }
+
+    /// Run \a f on each integer from 0 to \a count excluded, in
+    /// parallel.
+    template <typename F> void parallel_for(size_t count, F f)
+    {
+      llvm::ThreadPool pool{llvm::hardware_concurrency(count)};
+      for (size_t i = 0; i < count; ++i)
+        pool.async([&f, i] { f(i); });
+      pool.wait();
+    }
+
+    /// Make the hidden functions defined in \a module internal, unless
+    /// \a exported.
+    template <typename Pred>
+    void hidden_internalize(llvm::Module& module, Pred exported)
+    {
+      for (llvm::Function& function : module)
+        if (function.hasHiddenVisibility() && !function.isDeclaration()
+            && !exported(function))
+          {
+            function.setVisibility(llvm::Function::DefaultVisibility);
+            function.setLinkage(llvm::Function::InternalLinkage);
+          }
+    }
+
+    /// The functions of a program which have a body, in preorder.
+    class BodiesCollector
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      /// Super class.
+      using super_type = ast::DefaultConstVisitor;
+      /// Import overloaded operator() methods.
+      using super_type::operator();
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        if (e.body_get())
+          bodies.emplace_back(&e);
+        super_type::operator()(e);
+      }
+
+      /// The functions met so far.
+      function_decs_type bodies;
+    };
+
+  } // namespace
+
+  bool host_64()
+  {
+    return llvm::Triple(llvm::sys::getProcessTriple()).isArch64Bit();
+  }
+
+  misc::error prepare(ast::ChunkList& the_program)
+  {
+    misc::error error = bind::bind(the_program);
+    if (!error)
+      error << type::types_check(the_program);
+    if (error)
+      return error;
+    bind::rename(the_program);
+    error << desugar::desugar_in_place(the_program, true, true);
+    if (!error)
+      escapes::escapes_compute(the_program);
+    return error;
+  }
+
+  module_type translate(const ast::Ast& the_program, bool gc, bool target_64)
   {
     auto ctx = std::make_unique<llvm::LLVMContext>();
     auto module = std::make_unique<llvm::Module>(program_name, *ctx);
 
-    Translator translate{*module, collect_escapes(the_program)};
+    Translator translate{*module, collect_escapes(the_program), gc,
+                         target_64};
     translate(the_program);
+    data_layout_set(*module);
+
+    postcondition(!llvm::verifyModule(*module, &llvm::errs()));
+
+    return {std::move(ctx), std::move(module)};
+  }
+
+  partitions_type translate_partitions(const ast::Ast& the_program,
+                                       unsigned jobs,
+                                       bool gc,
+                                       bool target_64)
+  {
+    BodiesCollector collect;
+    collect(the_program);
+    const function_decs_type& bodies = collect.bodies;
+    const escaped_map_type escaped = collect_escapes(the_program);
+
+    // Consecutive functions, in at most a partition per job.
+    const size_t count =
+      std::max<size_t>(1, std::min<size_t>(jobs, bodies.size()));
+    partitions_type res(count);
+    native_target_initialize();
+    parallel_for(count, [&](size_t i) {
+      auto ctx = std::make_unique<llvm::LLVMContext>();
+      auto module = std::make_unique<llvm::Module>(program_name, *ctx);
+
+      Translator translate{*module, escaped_map_type{escaped}, gc,
+                           target_64};
+      translate.translate_partition(
+        {bodies.begin() + bodies.size() * i / count,
+         bodies.begin() + bodies.size() * (i + 1) / count});
+      data_layout_set(*module);
+
+      postcondition(!llvm::verifyModule(*module, &llvm::errs()));
+
+      res[i] = {std::move(ctx), std::move(module)};
+    });
+
+    // Only the functions called from other partitions remain hidden, the
+    // others are "static" again, as without partitions.
+    llvm::StringSet<> called;
+    for (const module_type& partition : res)
+      for (const llvm::Function& function : *partition.second)
+        if (function.hasHiddenVisibility() && function.isDeclaration())
+          called.insert(function.getName());
+    for (module_type& partition : res)
+      hidden_internalize(*partition.second,
+                         [&called](const llvm::Function& function) {
+                           return called.contains(function.getName());
+                         });
+
+    return res;
+  }
 
-    llvm::verifyModule(*module);
+  module_type partitions_link(partitions_type&& partitions)
+  {
+    // Modules of different contexts cannot be linked together: go
+    // through their bitcode, written in parallel.
+    std::vector<std::string> bitcodes(partitions.size());
+    parallel_for(partitions.size(), [&](size_t i) {
+      llvm::raw_string_ostream out{bitcodes[i]};
+      llvm::WriteBitcodeToFile(*partitions[i].second, out);
+      out.flush();
+      // The module first, then its context.
+      partitions[i].second.reset();
+      partitions[i].first.reset();
+    });
+    partitions.clear();
+
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto module = std::make_unique<llvm::Module>(program_name, *ctx);
+    for (const std::string& bitcode : bitcodes)
+      {
+        auto partition = llvm::cantFail(
+          llvm::parseBitcodeFile(llvm::MemoryBufferRef{bitcode, "partition"},
+                                 *ctx),
+          "invalid partition");
+        auto link = llvm::Linker::linkModules(*module, std::move(partition));
+        (void)link;
+        postcondition(!link); // Returns true on error
+      }
+
+    hidden_internalize(*module, [](const llvm::Function&) { return false; });
 
     return {std::move(ctx), std::move(module)};
   }
 
-  std::unique_ptr<llvm::Module> runtime_get(llvm::LLVMContext& ctx)
+  std::unique_ptr<llvm::Module> runtime_get(llvm::LLVMContext& ctx,
+                                            bool target_64)
+  {
+    // The bitcode is embedded in tc: it outlives the module.
+    auto runtime = llvm::getLazyBitcodeModule(
+      llvm::MemoryBufferRef{runtime_bitcode(target_64), "runtime"}, ctx);
+    return llvm::cantFail(std::move(runtime),
+                          "the embedded runtime is invalid");
+  }
+
+  void runtime_link(llvm::Module& module)
+  {
+    // The sizes of the types are folded in the bitcode: take the
+    // runtime compiled for the width of the target.
+    auto runtime = runtime_get(
+      module.getContext(),
+      llvm::Triple(module.getTargetTriple()).isArch64Bit());
+    // Only the functions used by the program are materialized and
+    // linked, along with the ones they use.  The `main' of the runtime
+    // is always needed, to run the program.
+    auto main_type =
+      llvm::FunctionType::get(llvm::Type::getInt32Ty(module.getContext()),
+                              false);
+    module.getOrInsertFunction("main", main_type);
+    auto link = llvm::Linker::linkModules(module, std::move(runtime),
+                                          llvm::Linker::LinkOnlyNeeded);
+    (void)link;
+    postcondition(!link); // Returns true on error
+  }
+
+  namespace
+  {
+    /// Whether \a pass only runs other passes, and is not worth timing.
+    bool is_pass_container(llvm::StringRef pass)
+    {
+      for (const char* container :
+           {"PassManager", "PassAdaptor", "AnalysisManagerProxy",
+            "DevirtSCCRepeatedPass", "ModuleInlinerWrapperPass"})
+        if (pass.contains(container))
+          return true;
+      return false;
+    }
+
+    /// Time each pass run under \a pic in \a timer.
+    void time_passes(llvm::PassInstrumentationCallbacks& pic,
+                     misc::timer& timer)
+    {
+      auto pop = [&timer](llvm::StringRef pass) {
+        if (!is_pass_container(pass))
+          timer.pop("llvm: " + pass.str());
+      };
+      pic.registerBeforeNonSkippedPassCallback(
+        [&timer](llvm::StringRef pass, llvm::Any) {
+          if (!is_pass_container(pass))
+            timer.push("llvm: " + pass.str());
+        });
+      pic.registerAfterPassCallback(
+        [pop](llvm::StringRef pass, llvm::Any,
+              const llvm::PreservedAnalyses&) { pop(pass); });
+      pic.registerAfterPassInvalidatedCallback(
+        [pop](llvm::StringRef pass, const llvm::PreservedAnalyses&) {
+          pop(pass);
+        });
+    }
+
+  } // namespace
+
+  void optimize(llvm::Module& module, unsigned level, misc::timer* timer)
+  {
+    precondition(1 <= level && level <= 3);
+
+    llvm::PassInstrumentationCallbacks pic;
+    if (timer)
+      time_passes(pic, *timer);
+
+    llvm::PassBuilder builder{nullptr, llvm::PipelineTuningOptions(),
+                              llvm::None, &pic};
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    builder.registerModuleAnalyses(mam);
+    builder.registerCGSCCAnalyses(cgam);
+    builder.registerFunctionAnalyses(fam);
+    builder.registerLoopAnalyses(lam);
+    builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+    static const llvm::OptimizationLevel levels[] = {
+      llvm::OptimizationLevel::O1, llvm::OptimizationLevel::O2,
+      llvm::OptimizationLevel::O3};
+
+    llvm::ModulePassManager passes;
+    // Once the program is complete, only its entry point is needed
+    // from the outside.
+    if (const llvm::Function* main = module.getFunction("main");
+        main && !main->isDeclaration())
+      passes.addPass(llvm::InternalizePass(
+        [](const llvm::GlobalValue& value) {
+          return value.getName() == "main";
+        }));
+    passes.addPass(builder.buildPerModuleDefaultPipeline(levels[level - 1]));
+    passes.run(module, mam);
+
+    postcondition(!llvm::verifyModule(module, &llvm::errs()));
+  }
+
+  void optimize(partitions_type& partitions, unsigned level)
+  {
+    precondition(1 <= level && level <= 3);
+    parallel_for(partitions.size(), [&](size_t i) {
+      optimize(*partitions[i].second, level);
+    });
+  }
+
+  misc::error emit_object(llvm::Module& module, const std::string& filename)
+  {
+    misc::error error;
+
+    std::string message;
+    const std::string& triple = module.getTargetTriple();
+    std::unique_ptr<llvm::TargetMachine> machine =
+      target_machine(triple, message);
+    if (!machine)
+      return error << misc::error::error_type::failure << program_name
+                   << ": " << message << '\n';
+    module.setDataLayout(machine->createDataLayout());
+
+    std::error_code ec;
+    llvm::raw_fd_ostream out{filename, ec, llvm::sys::fs::OF_None};
+    if (ec)
+      return error << misc::error::error_type::failure << program_name
+                   << ": cannot open `" << filename << "': " << ec.message()
+                   << '\n';
+
+    // Code generation is still run by the legacy pass manager.
+    llvm::legacy::PassManager passes;
+    if (machine->addPassesToEmitFile(passes, out, nullptr,
+                                     llvm::CGFT_ObjectFile))
+      return error << misc::error::error_type::failure << program_name
+                   << ": cannot emit object files for " << triple << '\n';
+    passes.run(module);
+    out.flush();
+
+    return error;
+  }
+
+  misc::error emit_objects(partitions_type& partitions,
+                           const std::vector<std::string>& filenames)
+  {
+    precondition(partitions.size() == filenames.size());
+    std::vector<misc::error> errors(partitions.size());
+    parallel_for(partitions.size(), [&](size_t i) {
+      errors[i] = emit_object(*partitions[i].second, filenames[i]);
+    });
+
+    misc::error error;
+    for (const misc::error& e : errors)
+      error << e;
+    return error;
+  }
+
+  misc::error link_executable(const std::vector<std::string>& objects,
+                              const std::string& filename,
+                              bool target_64)
+  {
+    misc::error error;
+
+    // Let the C compiler driver find the C library and the start files.
+    auto linker = llvm::sys::findProgramByName(LINKER);
+    if (!linker)
+      return error << misc::error::error_type::failure << program_name
+                   << ": cannot find `" << LINKER
+                   << "': " << linker.getError().message() << '\n';
+
+    std::vector<llvm::StringRef> args{*linker, target_64 ? "-m64" : "-m32"};
+    args.insert(args.end(), objects.begin(), objects.end());
+    args.insert(args.end(), {"-o", filename});
+
+    std::string message;
+    if (llvm::sys::ExecuteAndWait(*linker, args, llvm::None, {}, 0, 0,
+                                  &message))
+      error << misc::error::error_type::failure << program_name
+            << ": cannot link `" << filename << "'"
+            << (message.empty() ? "" : ": ") << message << '\n';
+
+    return error;
+  }
+
+  misc::error run(std::unique_ptr<llvm::LLVMContext> ctx,
+                  std::unique_ptr<llvm::Module> module,
+                  unsigned level,
+                  misc::timer* timer)
+  {
+    Jit jit;
+    misc::error error =
+      jit.add(std::move(ctx), std::move(module), level, timer);
+    if (error)
+      return error;
+
+    // The runtime's main sets its tables up before calling tc_main,
+    // and writes its output buffer after.
+    auto main = reinterpret_cast<int (*)()>(jit.lookup("main", error));
+    if (!main)
+      return error;
+    main();
+    // The buffer was written with the C library: flush it as exit would.
+    std::fflush(stdout);
+
+    return error;
+  }
+
+  misc::error run(const ast::Ast& the_program,
+                  bool gc,
+                  unsigned level,
+                  misc::timer* timer)
   {
-    llvm::SMDiagnostic diag;
-    return llvm::parseAssemblyString(runtime_string(), diag, ctx);
+    auto [ctx, module] = translate(the_program, gc, host_64());
+    runtime_link(*module);
+    return run(std::move(ctx), std::move(module), level, timer);
   }
 
 } // namespace llvmtranslate
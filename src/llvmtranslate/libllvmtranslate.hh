@@ -6,26 +6,131 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include <llvm/ADT/StringRef.h>
 #include <llvm/IR/LLVMContext.h>
 
 #include <ast/fwd.hh>
 #include <llvmtranslate/fwd.hh>
+#include <misc/error.hh>
+#include <misc/fwd.hh>
 
 /// Translation from ast::Ast to llvm::Value.
 namespace llvmtranslate
 {
-  /// Translate the file into a llvm::Module.
-  std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>>
-  translate(const ast::Ast& the_program);
+  /// A llvm::Module, along with the llvm::LLVMContext that owns it.
+  using module_type = std::pair<std::unique_ptr<llvm::LLVMContext>,
+                                std::unique_ptr<llvm::Module>>;
 
-  /// Load the runtime as a llvm::Module.
-  std::unique_ptr<llvm::Module> runtime_get(llvm::LLVMContext& ctx);
+  /// The modules of the partitions of a program.
+  using partitions_type = std::vector<module_type>;
 
-  /// The LLVM runtime as a string, loaded from the generated file.
+  /// Whether the host, on which tc runs, is a 64-bit target: the
+  /// value of the \a target_64 argument of translate for the JIT.
+  bool host_64();
+
+  /** \brief Prepare \a the_program for translate, as the tasks that
+   ** --llvm-compute depends on do.
+   **
+   ** It is bound and type-checked, renamed, its `for' loops and string
+   ** comparisons are desugared, and its escapes are computed.  Stop at
+   ** the first step that fails, and return its errors.
+   **/
+  misc::error prepare(ast::ChunkList& the_program);
+
+  /// Translate the file into a llvm::Module, allocating with the
+  /// garbage collector of the runtime if \a gc, for the 64-bit variant
+  /// of the host if \a target_64 and its 32-bit variant otherwise.
+  module_type translate(const ast::Ast& the_program,
+                        bool gc = false,
+                        bool target_64 = false);
+
+  /** \brief Translate the file as translate does, its functions being
+   ** split in \a jobs partitions, translated in parallel.
+   **
+   ** Each partition is a module of its own context, which can be
+   ** optimized and compiled on its own, its functions being hidden
+   ** rather than internal.  They are in the order of the functions of
+   ** the program, whatever their scheduling.
+   **/
+  partitions_type translate_partitions(const ast::Ast& the_program,
+                                       unsigned jobs,
+                                       bool gc = false,
+                                       bool target_64 = false);
+
+  /// Link the \a partitions in a single module, in order.  Its Tiger
+  /// functions are internal again.
+  module_type partitions_link(partitions_type&& partitions);
+
+  /// Load the runtime compiled for the 64-bit variant of the host if
+  /// \a target_64, for its 32-bit variant otherwise, as a llvm::Module
+  /// whose functions are materialized lazily, when they are used.
+  std::unique_ptr<llvm::Module> runtime_get(llvm::LLVMContext& ctx,
+                                            bool target_64);
+
+  /// Link the runtime compiled for the target of \a module into it:
+  /// only its `main', and the parts of it that \a module uses.
+  void runtime_link(llvm::Module& module);
+
+  /** \brief Run the default LLVM optimization pipeline of \a level
+   ** (1 to 3) on \a module.
+   **
+   ** If \a module defines `main' (i.e., the runtime was linked in),
+   ** every other symbol is internalized first, so that the runtime
+   ** primitives can be inlined and the unused ones removed.
+   **
+   ** If \a timer is not null, each pass is timed in it.
+   **/
+  void optimize(llvm::Module& module,
+                unsigned level,
+                misc::timer* timer = nullptr);
+
+  /// Optimize each of the \a partitions at \a level (1 to 3), in
+  /// parallel.
+  void optimize(partitions_type& partitions, unsigned level);
+
+  /// Compile \a module to the native object file \a filename, for the
+  /// target of \a module.
+  misc::error emit_object(llvm::Module& module, const std::string& filename);
+
+  /// Compile each of the \a partitions to the object file of the same
+  /// rank in \a filenames, in parallel.
+  misc::error emit_objects(partitions_type& partitions,
+                           const std::vector<std::string>& filenames);
+
+  /// Link the object files \a objects, along with the C library, into
+  /// the executable \a filename, for a 64-bit target if \a target_64.
+  misc::error link_executable(const std::vector<std::string>& objects,
+                              const std::string& filename,
+                              bool target_64 = false);
+
+  /** \brief JIT-compile \a module for the host, and run its `main'.
+   **
+   ** \a module must include the runtime, and be translated for the
+   ** host (see host_64).  It is optimized at \a level (0 to 3), the
+   ** passes being timed in \a timer if it is not null.
+   **/
+  misc::error run(std::unique_ptr<llvm::LLVMContext> ctx,
+                  std::unique_ptr<llvm::Module> module,
+                  unsigned level,
+                  misc::timer* timer = nullptr);
+
+  /// Translate \a the_program (see prepare) for the host, allocating
+  /// with the garbage collector if \a gc, link the runtime into it,
+  /// and run it as the other run does.
+  misc::error run(const ast::Ast& the_program,
+                  bool gc,
+                  unsigned level,
+                  misc::timer* timer = nullptr);
+
+  /// The LLVM runtime as bitcode, compiled for the 64-bit variant of the
+  /// host if \a target_64, for its 32-bit variant otherwise, embedded
+  /// in the generated file.
   /// This function is implemented in $(build_dir)/src/llvmtranslate/runtime.cc
   /// For more information take a look at `local.am`.
-  const char* runtime_string();
+  llvm::StringRef runtime_bitcode(bool target_64);
 
 } // namespace llvmtranslate
@@ -3,7 +3,11 @@
  ** \brief LLVM Translate tasks.
  */
 
+#include <cstdlib>
+#include <filesystem>
 #include <memory>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -12,43 +16,181 @@
 #include <llvm/IR/IRPrintingPasses.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/PassManager.h>
-#include <llvm/Linker/Linker.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h> // llvm::outs()
 
 #pragma GCC diagnostic pop
 
 #include <ast/tasks.hh>
+#include <common.hh>
 #include <llvmtranslate/fwd.hh>
 #include <llvmtranslate/libllvmtranslate.hh>
 #define DEFINE_TASKS 1
 #include <llvmtranslate/tasks.hh>
 #undef DEFINE_TASKS
+#include <task/task-register.hh>
 
 namespace llvmtranslate::tasks
 {
   std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>>
     module = {nullptr, nullptr};
 
+  int llvm_optimize_level = 0;
+  int llvm_jobs = 1;
+
+  namespace
+  {
+    /// The partitions of the program with --llvm-jobs, until they are
+    /// linked in the module.
+    partitions_type partitions;
+    /// Whether the runtime is already part of the module.
+    bool runtime_linked = false;
+    /// Whether the module was optimized, for its own target.
+    bool optimized = false;
+
+    /// The name of the output file: --llvm-output if set, \a name
+    /// otherwise.  Exit rather than write over the input file.
+    std::string output_name(const std::string& name)
+    {
+      const std::string res = llvm_output.empty() ? name : llvm_output;
+      std::error_code ec;
+      if (std::string(filename) != "-"
+          && std::filesystem::equivalent(filename, res, ec))
+        task_error() << misc::error::error_type::failure << program_name
+                     << ": " << res << ": is the input file\n"
+                     << &misc::error::exit;
+      return res;
+    }
+
+    /// The prebuilt runtime object file, for the target.
+    std::string runtime_object()
+    {
+      const char* tc_pkglibdir = getenv("TC_PKGLIBDIR");
+      return std::string(tc_pkglibdir ? tc_pkglibdir : PKGLIBDIR)
+        + (llvm_64_p ? "/tiger-runtime-64.o" : "/tiger-runtime.o");
+    }
+
+    /// Link the partitions, if any, in the module.
+    void module_complete()
+    {
+      if (!partitions.empty())
+        module = partitions_link(std::move(partitions));
+    }
+
+  } // namespace
+
   /// Translate the AST to LLVM IR.
-  void llvm_compute() { module = translate(*ast::tasks::the_program); }
+  void llvm_compute()
+  {
+    // The module must be destroyed before its context.
+    module.second.reset();
+    module.first.reset();
+    if (llvm_jobs > 1)
+      partitions = translate_partitions(*ast::tasks::the_program, llvm_jobs,
+                                        llvm_gc_p, llvm_64_p);
+    else
+      module = translate(*ast::tasks::the_program, llvm_gc_p, llvm_64_p);
+    runtime_linked = false;
+    optimized = false;
+  }
+
+  /// Optimize the LLVM IR.
+  void llvm_optimize_compute()
+  {
+    if (!llvm_optimize_level)
+      return;
+
+    // Optimize each partition on its own, the runtime being linked
+    // as an object file.
+    if (!partitions.empty())
+      {
+        optimize(partitions, llvm_optimize_level);
+        optimized = true;
+        return;
+      }
+
+    // Optimize the whole program, so that the runtime primitives can
+    // be inlined.
+    runtime_link(*module.second);
+    runtime_linked = true;
+    // Time the passes within this task.
+    optimize(*module.second, llvm_optimize_level,
+             &task::TaskRegister::instance().timer_get());
+    optimized = true;
+  }
+
+  /// Compile the program to a native object file.
+  void llvm_emit_obj()
+  {
+    module_complete();
+    const std::filesystem::path input{filename};
+    const std::string name =
+      (input == "-" ? "a" : input.stem().string()) + ".o";
+    task_error() << emit_object(*module.second, output_name(name))
+                 << &misc::error::exit_on_error;
+  }
+
+  /// Compile the program to a native executable.
+  void llvm_emit_exe()
+  {
+    const std::string output = output_name("a.out");
+
+    // An object file per partition, or for the whole module.
+    const size_t count = partitions.empty() ? 1 : partitions.size();
+    std::vector<std::string> objects;
+    for (size_t i = 0; i < count; ++i)
+      {
+        llvm::SmallString<128> object;
+        if (std::error_code ec =
+              llvm::sys::fs::createTemporaryFile("tc", "o", object))
+          task_error() << misc::error::error_type::failure << program_name
+                       << ": cannot create a temporary file: "
+                       << ec.message() << '\n'
+                       << &misc::error::exit;
+        objects.emplace_back(object.str().str());
+      }
+    // The runtime is already in the module if it was optimized.
+    if (!runtime_linked)
+      objects.emplace_back(runtime_object());
+
+    misc::error error = partitions.empty()
+      ? emit_object(*module.second, objects.front())
+      : emit_objects(partitions, {objects.begin(), objects.begin() + count});
+    if (!error)
+      error = link_executable(objects, output, llvm_64_p);
+    for (size_t i = 0; i < count; ++i)
+      llvm::sys::fs::remove(objects[i]);
+    task_error() << error << &misc::error::exit_on_error;
+  }
+
+  /// JIT-compile and run the program.
+  void llvm_run()
+  {
+    // The JIT compiles for the host, and owns the module it runs: give
+    // it a translation of its own, so that the module remains for the
+    // following tasks, whatever its target.
+    auto [ctx, program] = llvm_jobs > 1
+      ? partitions_link(translate_partitions(*ast::tasks::the_program,
+                                             llvm_jobs, llvm_gc_p, host_64()))
+      : translate(*ast::tasks::the_program, llvm_gc_p, host_64());
+    runtime_link(*program);
+    task_error() << run(std::move(ctx), std::move(program),
+                        llvm_optimize_level,
+                        &task::TaskRegister::instance().timer_get())
+                 << &misc::error::exit_on_error;
+  }
 
   /// Display the LLVM IR.
   void llvm_display()
   {
+    module_complete();
+
     // If the runtime has to be displayed, get the runtime module,
     // link it with the program module and print it.
-    if (llvm_runtime_display_p)
+    if (llvm_runtime_display_p && !runtime_linked)
       {
-        auto runtime = runtime_get(*module.first);
-#if LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 7
-        auto link =
-          llvm::Linker::LinkModules(module.second.get(), runtime.get());
-#else
-        auto link =
-          llvm::Linker::linkModules(*module.second, std::move(runtime));
-#endif
-        (void)link;
-        postcondition(!link); // Returns true on error
+        runtime_link(*module.second);
+        runtime_linked = true;
       }
 
     auto& out = llvm::outs();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include <llvmtranslate/fwd.hh>
 #include <task/libtask.hh>
 
@@ -10,14 +12,91 @@ namespace llvmtranslate::tasks
                    std::unique_ptr<llvm::Module>>
     module;
 
+  /// The optimization level of the LLVM IR, 0 to disable.
+  extern int llvm_optimize_level;
+
+  /// The number of partitions of the functions, compiled in parallel.
+  extern int llvm_jobs;
+
   TASK_GROUP("5.5. Translation to LLVM Intermediate Representation");
 
+  /// Allocate with the garbage collector of the runtime.
+  BOOLEAN_TASK_DECLARE("gc",
+                       "collect the garbage of the compiled program "
+                       "(conservative mark and sweep)",
+                       llvm_gc_p,
+                       "");
+
+  /// Compile for the native 64-bit target.
+  BOOLEAN_TASK_DECLARE("llvm-64",
+                       "compile for the 64-bit variant of the host, "
+                       "instead of its 32-bit one",
+                       llvm_64_p,
+                       "");
+
+  /// Set the number of partitions compiled in parallel.
+  INT_TASK_DECLARE("llvm-jobs",
+                   1,
+                   std::numeric_limits<int>::max(),
+                   "split the functions in NUM partitions, translated, "
+                   "optimized and compiled in parallel, each in its own "
+                   "LLVM context (the runtime primitives are then not "
+                   "inlined), defaults to 1",
+                   llvm_jobs,
+                   "");
+
   /// Translate the AST to LLVM IR.
   TASK_DECLARE("llvm-compute",
                "translate to LLVM IR",
                llvm_compute,
                "typed desugar-for desugar-string-cmp desugar escapes-compute");
 
+  /// Set the optimization level of the LLVM IR.
+  INT_TASK_DECLARE("llvm-optimize",
+                   0,
+                   3,
+                   "optimize the LLVM IR at level NUM (0 to 3), "
+                   "with the runtime linked in",
+                   llvm_optimize_level,
+                   "llvm-optimize-compute");
+
+  /// Optimize the LLVM IR, if requested.
+  TASK_DECLARE("llvm-optimize-compute",
+               "run the LLVM optimization pipeline",
+               llvm_optimize_compute,
+               "llvm-compute");
+
+  /// The output file of the native compilation.
+  STRING_TASK_DECLARE("llvm-output",
+                      "",
+                      "write the object file or the executable to FILE, "
+                      "which must not be the input file",
+                      llvm_output,
+                      "");
+
+  /// Compile the program to a native object file.
+  TASK_DECLARE("llvm-emit-obj",
+               "write the native object file of the program to "
+               "--llvm-output, defaults to `INPUT.o', INPUT being the "
+               "input file name without directory and extension",
+               llvm_emit_obj,
+               "llvm-optimize-compute");
+
+  /// Compile the program to a native executable.
+  TASK_DECLARE("llvm-emit-exe",
+               "write the native executable of the program, linked with "
+               "the runtime object file, to --llvm-output, defaults to "
+               "`a.out'",
+               llvm_emit_exe,
+               "llvm-optimize-compute");
+
+  /// Run the program in tc.
+  TASK_DECLARE("llvm-run",
+               "JIT-compile the program with the runtime, optimized at the "
+               "--llvm-optimize level, and run it",
+               llvm_run,
+               "typed desugar-for desugar-string-cmp desugar escapes-compute");
+
   /// Activate displaying the runtime along with the LLVM IR.
   BOOLEAN_TASK_DECLARE("llvm-runtime-display",
                        "enable runtime displaying"
@@ -29,6 +108,6 @@ namespace llvmtranslate::tasks
   TASK_DECLARE("llvm-display",
                "display the LLVM IR",
                llvm_display,
-               "llvm-compute");
+               "llvm-optimize-compute");
 
 } // namespace llvmtranslate::tasks
@@ -3,29 +3,536 @@
    \brief C Implementation of the Tiger runtime.
 */
 
+// For isatty and read.
+#define _POSIX_C_SOURCE 200112L
+
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#ifndef __GNUC__
+#  include <setjmp.h>
+#endif
+
+#include "tiger-runtime.h"
 
 #define EXIT_RUNTIME_FAILURE 120
 
 // FWD, declared by tc
 void tc_main(int);
 
+/** \name Memory management. */
+/** \{ */
+
+/* Objects are allocated by bumping tc_alloc_cursor up to
+   tc_alloc_limit, the end of the current region.  The compiled code
+   does it inline for records, and calls tc_alloc when the region is
+   full.  Tiger programs are single-threaded: the region is global.
+
+   Without the garbage collector, the regions are chunks of memory from
+   malloc, never freed.  The garbage collector is enabled by tc_gc_init
+   in the programs compiled with --gc.
+
+   It is a conservative, non-moving, mark-sweep collector.  The heap is
+   a set of blocks, and the regions are the free runs the previous
+   collection left in them.  Each object is preceded by a header, and
+   so is each free run, so that a block can be walked object by object.
+
+   The roots are the words of the stack from the collector up to the
+   frame of tc_main, the callee-saved registers being spilled first: the
+   compiled code keeps pointers in registers and temporaries it does not
+   describe.  Any word pointing into an object keeps it alive, and so
+   do the words of the live objects, except strings, which hold no
+   pointer.  */
+
+/* The unit of allocation, in bytes, as assumed by the compiler. */
+#define GC_GRANULE 8
+/* The size of the regions without the collector, in bytes. */
+#define REGION_SIZE (1 << 20)
+/* The size of the objects area of a block, in granules. */
+#define GC_BLOCK_GRANULES 32768
+/* Larger objects, in granules, get a block of their own. */
+#define GC_LARGE_GRANULES (GC_BLOCK_GRANULES / 4)
+/* The initial size of the tables, which double when full. */
+#define GC_TABLE_MIN 256
+/* The allocation, in bytes, that triggers the first collection. */
+#define GC_THRESHOLD_MIN (4 << 20)
+
+#ifdef __GNUC__
+#  define GC_NOINLINE __attribute__((noinline))
+#else
+#  define GC_NOINLINE
+#endif
+
+enum gc_flag
+{
+  GC_MARKED = 1,
+  /* Holds no pointer. */
+  GC_ATOMIC = 2,
+  /* A free run, not an object. */
+  GC_FREE = 4,
+};
+
+/* The current region. */
+char *tc_alloc_cursor = NULL;
+char *tc_alloc_limit = NULL;
+
+/* The header of the objects, written by the compiler too. */
+typedef struct gc_header
+{
+  /* The size, header included, in granules. */
+  uint32_t granules;
+  uint32_t flags;
+} gc_header;
+
+static struct
+{
+  /* The frame of tc_main, or NULL if the collector is disabled. */
+  char *stack_base;
+  /* The objects area of the blocks, sorted by address, and their end.
+     The bitmap of the object starts is right before each area. */
+  char **blocks;
+  char **ends;
+  size_t nblocks;
+  size_t blocks_max;
+  /* The free runs left by the last collection, from runs[run]. */
+  char **runs;
+  size_t nruns;
+  size_t runs_max;
+  size_t run;
+  /* The objects marked, but not scanned yet. */
+  gc_header **marks;
+  size_t nmarks;
+  size_t marks_max;
+  /* Whether some marked objects did not fit in marks. */
+  int overflow;
+  /* The bytes allocated since the last collection, counting the whole
+     of the regions, as the compiled code allocates from them inline,
+     and the amount that triggers the next one. */
+  size_t allocated;
+  size_t threshold;
+} gc;
+
+/* The next size of a table of \a max elements. */
+static size_t gc_table_grow(size_t max)
+{
+  return max ? 2 * max : GC_TABLE_MIN;
+}
+
+/* Resize \a table to \a max elements of \a size bytes. */
+static void *gc_table_resize(void *table, size_t max, size_t size)
+{
+  void *res = realloc(table, max * size);
+  if (!res)
+    tc_runtime_failure("gc: out of memory");
+  return res;
+}
+
+/* The size of the bitmap of a block of \a granules, in bytes. */
+static size_t gc_bitmap_size(size_t granules)
+{
+  return (granules + 8 * GC_GRANULE - 1) / (8 * GC_GRANULE) * GC_GRANULE;
+}
+
+static unsigned char *gc_bitmap(size_t block)
+{
+  size_t granules = (gc.ends[block] - gc.blocks[block]) / GC_GRANULE;
+  return (unsigned char *) gc.blocks[block] - gc_bitmap_size(granules);
+}
+
+/* Add a block of \a granules to the heap, and return it, as a single
+   free run. */
+static char *gc_block_new(size_t granules)
+{
+  size_t bitmap = gc_bitmap_size(granules);
+  char *base = calloc(1, bitmap + granules * GC_GRANULE);
+  if (!base)
+    tc_runtime_failure("gc: out of memory");
+  if (gc.nblocks == gc.blocks_max)
+  {
+    gc.blocks_max = gc_table_grow(gc.blocks_max);
+    gc.blocks = gc_table_resize(gc.blocks, gc.blocks_max, sizeof (char *));
+    gc.ends = gc_table_resize(gc.ends, gc.blocks_max, sizeof (char *));
+  }
+
+  char *start = base + bitmap;
+  size_t i = gc.nblocks++;
+  for (; i && start < gc.blocks[i - 1]; --i)
+  {
+    gc.blocks[i] = gc.blocks[i - 1];
+    gc.ends[i] = gc.ends[i - 1];
+  }
+  gc.blocks[i] = start;
+  gc.ends[i] = start + granules * GC_GRANULE;
+
+  gc_header *run = (gc_header *) start;
+  run->granules = granules;
+  run->flags = GC_FREE;
+  return start;
+}
+
+/* The object \a p points into, if any. */
+static gc_header *gc_find(const char *p)
+{
+  if (!gc.nblocks || p < gc.blocks[0] || !(p < gc.ends[gc.nblocks - 1]))
+    return NULL;
+
+  // The last block starting at or before p.
+  size_t lo = 0;
+  size_t hi = gc.nblocks;
+  while (hi - lo > 1)
+  {
+    size_t mid = lo + (hi - lo) / 2;
+    if (p < gc.blocks[mid])
+      hi = mid;
+    else
+      lo = mid;
+  }
+  if (!(p < gc.ends[lo]))
+    return NULL;
+
+  // The last object starting at or before p.
+  const unsigned char *bitmap = gc_bitmap(lo);
+  size_t granule = (p - gc.blocks[lo]) / GC_GRANULE;
+  size_t byte = granule / 8;
+  unsigned bits = bitmap[byte] & ((2u << granule % 8) - 1);
+  while (!bits)
+  {
+    if (!byte)
+      return NULL;
+    bits = bitmap[--byte];
+  }
+  int bit = 7;
+  while (!(bits >> bit & 1))
+    --bit;
+
+  gc_header *res =
+    (gc_header *) (gc.blocks[lo] + (byte * 8 + bit) * GC_GRANULE);
+  return p < (char *) res + res->granules * GC_GRANULE ? res : NULL;
+}
+
+/* Make the rest of the current run a free run, so that its block can
+   be walked. */
+static void gc_retire(void)
+{
+  if (tc_alloc_cursor < tc_alloc_limit)
+  {
+    gc_header *run = (gc_header *) tc_alloc_cursor;
+    run->granules = (tc_alloc_limit - tc_alloc_cursor) / GC_GRANULE;
+    run->flags = GC_FREE;
+  }
+  tc_alloc_cursor = tc_alloc_limit = NULL;
+}
+
+/* Record where the objects start. */
+static void gc_parse(void)
+{
+  for (size_t i = 0; i < gc.nblocks; ++i)
+  {
+    unsigned char *bitmap = gc_bitmap(i);
+    memset(bitmap, 0, gc.blocks[i] - (char *) bitmap);
+    const gc_header *h;
+    for (char *p = gc.blocks[i]; p < gc.ends[i];
+         p += h->granules * GC_GRANULE)
+    {
+      h = (const gc_header *) p;
+      if (!(h->flags & GC_FREE))
+      {
+        size_t granule = (p - gc.blocks[i]) / GC_GRANULE;
+        bitmap[granule / 8] |= 1u << granule % 8;
+      }
+    }
+  }
+}
+
+/* Mark the object \a p points into, if any. */
+static void gc_mark(const char *p)
+{
+  gc_header *h = gc_find(p);
+  if (!h || h->flags & GC_MARKED)
+    return;
+  h->flags |= GC_MARKED;
+  if (h->flags & GC_ATOMIC)
+    return;
+  // Rather than fail, rescan the heap if the table cannot grow.
+  if (gc.nmarks == gc.marks_max)
+  {
+    size_t max = gc_table_grow(gc.marks_max);
+    gc_header **marks = realloc(gc.marks, max * sizeof (gc_header *));
+    if (marks)
+    {
+      gc.marks = marks;
+      gc.marks_max = max;
+    }
+  }
+  if (gc.nmarks < gc.marks_max)
+    gc.marks[gc.nmarks++] = h;
+  else
+    gc.overflow = 1;
+}
+
+/* Mark the objects pointed to by the words from \a begin to \a end,
+   i.e., by the pointers of the target. */
+static void gc_mark_range(const char *begin, const char *end)
+{
+  for (const char *p = begin; p < end; p += sizeof (char *))
+    gc_mark(*(char *const *) p);
+}
+
+static void gc_mark_children(const gc_header *h)
+{
+  gc_mark_range((const char *) (h + 1),
+                (const char *) h + h->granules * GC_GRANULE);
+}
+
+/* Mark from the stack, up to the frame of tc_main.  Not inlined, so
+   that the frame of its caller is scanned too. */
+static GC_NOINLINE void gc_mark_stack(void)
+{
+  char *top = NULL;
+  gc_mark_range((const char *) &top, gc.stack_base);
+}
+
+/* Scan the marked objects. */
+static void gc_drain(void)
+{
+  for (;;)
+  {
+    while (gc.nmarks)
+      gc_mark_children(gc.marks[--gc.nmarks]);
+    if (!gc.overflow)
+      return;
+
+    // Some marked objects were not scanned: scan them all again.
+    gc.overflow = 0;
+    for (size_t i = 0; i < gc.nblocks; ++i)
+    {
+      const gc_header *h;
+      for (char *p = gc.blocks[i]; p < gc.ends[i];
+           p += h->granules * GC_GRANULE)
+      {
+        h = (const gc_header *) p;
+        if ((h->flags & (GC_MARKED | GC_ATOMIC | GC_FREE)) == GC_MARKED)
+        {
+          gc_mark_children(h);
+          while (gc.nmarks)
+            gc_mark_children(gc.marks[--gc.nmarks]);
+        }
+      }
+    }
+  }
+}
+
+/* Make a free run from \a run to \a end. */
+static void gc_run_new(gc_header *run, char *end)
+{
+  run->granules = (end - (char *) run) / GC_GRANULE;
+  run->flags = GC_FREE;
+  // Allocate zeroed memory, as calloc.
+  memset(run + 1, 0, end - (char *) (run + 1));
+  if (gc.nruns == gc.runs_max)
+  {
+    gc.runs_max = gc_table_grow(gc.runs_max);
+    gc.runs = gc_table_resize(gc.runs, gc.runs_max, sizeof (char *));
+  }
+  gc.runs[gc.nruns++] = (char *) run;
+}
+
+/* Free the objects not marked, and the blocks without live objects. */
+static void gc_sweep(void)
+{
+  size_t live = 0;
+  size_t nblocks = 0;
+  gc.nruns = gc.run = 0;
+  for (size_t i = 0; i < gc.nblocks; ++i)
+  {
+    size_t nruns = gc.nruns;
+    size_t block_live = 0;
+    gc_header *run = NULL;
+    for (char *p = gc.blocks[i]; p < gc.ends[i];)
+    {
+      gc_header *h = (gc_header *) p;
+      p += h->granules * GC_GRANULE;
+      if (h->flags & GC_MARKED)
+      {
+        h->flags &= ~GC_MARKED;
+        block_live += h->granules * GC_GRANULE;
+        if (run)
+          gc_run_new(run, (char *) h);
+        run = NULL;
+      }
+      else if (!run)
+        run = h;
+    }
+
+    if (block_live)
+    {
+      if (run)
+        gc_run_new(run, gc.ends[i]);
+      live += block_live;
+      gc.blocks[nblocks] = gc.blocks[i];
+      gc.ends[nblocks] = gc.ends[i];
+      ++nblocks;
+    }
+    else
+    {
+      gc.nruns = nruns;
+      free(gc_bitmap(i));
+    }
+  }
+  gc.nblocks = nblocks;
+
+  gc.allocated = 0;
+  gc.threshold = live < GC_THRESHOLD_MIN ? GC_THRESHOLD_MIN : live;
+}
+
+static void gc_collect(void)
+{
+  gc_retire();
+  // Spill the callee-saved registers into this frame.
+#ifdef __GNUC__
+  __builtin_unwind_init();
+#else
+  jmp_buf registers;
+  setjmp(registers);
+#endif
+  gc_parse();
+  gc_mark_stack();
+  gc_drain();
+  gc_sweep();
+}
+
+/* Make the current run hold at least \a size bytes. */
+static void gc_refill(size_t size)
+{
+  gc_retire();
+  if (gc.allocated >= gc.threshold)
+    gc_collect();
+
+  while (gc.run < gc.nruns)
+  {
+    char *run = gc.runs[gc.run++];
+    size_t run_size = ((gc_header *) run)->granules * GC_GRANULE;
+    if (size <= run_size)
+    {
+      tc_alloc_cursor = run;
+      tc_alloc_limit = run + run_size;
+      gc.allocated += run_size;
+      return;
+    }
+  }
+  tc_alloc_cursor = gc_block_new(GC_BLOCK_GRANULES);
+  tc_alloc_limit = tc_alloc_cursor + GC_BLOCK_GRANULES * GC_GRANULE;
+  gc.allocated += GC_BLOCK_GRANULES * GC_GRANULE;
+}
+
+static void *gc_alloc(size_t size, uint32_t flags)
+{
+  size_t granules = 1 + (size + GC_GRANULE - 1) / GC_GRANULE;
+  size_t bytes = granules * GC_GRANULE;
+  gc_header *h;
+  if (granules > GC_LARGE_GRANULES)
+  {
+    if (gc.allocated >= gc.threshold)
+      gc_collect();
+    h = (gc_header *) gc_block_new(granules);
+    gc.allocated += bytes;
+  }
+  else
+  {
+    if ((size_t) (tc_alloc_limit - tc_alloc_cursor) < bytes)
+      gc_refill(bytes);
+    h = (gc_header *) tc_alloc_cursor;
+    tc_alloc_cursor += bytes;
+  }
+  h->granules = granules;
+  h->flags = flags;
+  return h + 1;
+}
+
+/* Allocate \a size bytes without the collector. */
+static void *region_alloc(size_t size)
+{
+  // Empty objects are distinct too.
+  if (!size)
+    size = 1;
+  size = (size + GC_GRANULE - 1) / GC_GRANULE * GC_GRANULE;
+  if (size > REGION_SIZE / 4)
+    return malloc(size);
+
+  if ((size_t) (tc_alloc_limit - tc_alloc_cursor) < size)
+  {
+    tc_alloc_cursor = malloc(REGION_SIZE);
+    if (!tc_alloc_cursor)
+      tc_runtime_failure("out of memory");
+    tc_alloc_limit = tc_alloc_cursor + REGION_SIZE;
+  }
+  void *res = tc_alloc_cursor;
+  tc_alloc_cursor += size;
+  return res;
+}
+
+/* Allocate \a size bytes, that hold no pointer if \a atomic. */
+static void *runtime_alloc(size_t size, int atomic)
+{
+  if (!gc.stack_base)
+    return region_alloc(size);
+  return gc_alloc(size, atomic ? GC_ATOMIC : 0);
+}
+
+/** \brief Enable the garbage collector.
+    \param stack_base  The frame of tc_main.
+
+    Called first by tc_main when compiled with --gc.
+*/
+void tc_gc_init(void *stack_base)
+{
+  // Leave the region of the allocations without the collector.
+  tc_alloc_cursor = tc_alloc_limit = NULL;
+  gc.stack_base = stack_base;
+  gc.threshold = GC_THRESHOLD_MIN;
+}
+
+/** \brief Allocate a record.
+    \param size    Its size in bytes.
+
+    Called by the compiled code when the current region is full.
+*/
+void *tc_alloc(int size)
+{
+  return runtime_alloc(size, 0);
+}
+/** \} */
+
 /** \name Internal functions (calls generated by the compiler only). */
 /** \{ */
 
 /** \brief Allocate an array and fill it with a default value.
-    \param size    The size of the array.
-    \param elt     The default element.
-
-    An element size is always the size of a word on 32-bit systems.
+    \param size      The size of the array.
+    \param elt_size  The size of an element: 4, or 8 for pointers on
+                     64-bit targets.
+    \param elt       The default element, extended to 64 bits.
 */
-int *tc_init_array(int size, int elt)
+void *tc_init_array(int size, int elt_size, int64_t elt)
 {
-  int *arr = (int *)malloc(size * sizeof (elt));
-  for (size_t i = 0; i < size; ++i)
-    arr[i] = elt;
+  char *arr = runtime_alloc((size_t) size * elt_size, 0);
+  // Fill by copying the initialized prefix after itself, doubling it:
+  // memcpy is vectorized even when the runtime is not optimized.
+  if (size > 0)
+  {
+    if (elt_size == sizeof (int32_t))
+      *(int32_t *) arr = elt;
+    else
+      *(int64_t *) arr = elt;
+    size_t bytes = (size_t) size * elt_size;
+    for (size_t filled = elt_size; filled < bytes; filled *= 2)
+    {
+      size_t n = bytes - filled < filled ? bytes - filled : filled;
+      memcpy(arr + filled, arr, n);
+    }
+  }
   return arr;
 }
 /** \} */
@@ -46,6 +553,7 @@ int tc_not(int i)
 */
 void tc_exit(int status)
 {
+  tc_flush();
   exit(status);
 }
 /** \} */
@@ -53,9 +561,104 @@ void tc_exit(int status)
 /** \name Operations on strings. */
 /** \{ */
 
-// Small trick. Add a \0 after each char in the consts
-// This is filled in tc_main
-static char consts[512] = { 0 };
+/* A string is the address of its characters, followed by a NUL, and
+   preceded by their number, as a 32-bit integer.  The compiler lays the
+   string literals out so.
+
+   Concatenating to a long string makes a slice instead: the prefix of
+   a buffer, where the following concatenations append in place, as
+   long as the string they extend is the whole of what the buffer
+   holds.  Otherwise a new buffer, twice as large, is made, so that a
+   string built by concatenations in a loop is copied O(1) times per
+   character, instead of at every step.  The characters of a slice are
+   not followed by a NUL.  */
+
+/* Longer concatenations make slices. */
+#define STRING_FLAT_MAX 64
+/* The tag of the slices, in place of the length of the flat strings. */
+#define STRING_SLICE -1
+
+typedef struct string_buffer
+{
+  int32_t capacity;
+  /* The number of characters of the longest slice. */
+  int32_t used;
+  char chars[];
+} string_buffer;
+
+typedef struct string_slice
+{
+  int32_t length;
+  int32_t tag;
+  /* The string is the address of this field. */
+  string_buffer *buffer;
+} string_slice;
+
+/* The slice the string \a s is, if any. */
+static string_slice *string_slice_of(const char *s)
+{
+  if (((const int32_t *) s)[-1] != STRING_SLICE)
+    return NULL;
+  return (string_slice *) (s - offsetof(string_slice, buffer));
+}
+
+/* The length of the string \a s. */
+static int32_t string_length(const char *s)
+{
+  int32_t res = ((const int32_t *) s)[-1];
+  return res != STRING_SLICE ? res : string_slice_of(s)->length;
+}
+
+/* The characters of the string \a s. */
+static const char *string_chars(const char *s)
+{
+  string_slice *slice = string_slice_of(s);
+  return slice ? slice->buffer->chars : s;
+}
+
+/* Allocate a string of \a length characters, set but for the NUL. */
+static char *string_new(size_t length)
+{
+  int32_t *res = runtime_alloc(sizeof (int32_t) + length + 1, 1);
+  *res = length;
+  char *chars = (char *) (res + 1);
+  chars[length] = '\0';
+  return chars;
+}
+
+/* Make the slice of the \a length first characters of \a buffer. */
+static const char *string_slice_new(string_buffer *buffer, int32_t length)
+{
+  string_slice *res = runtime_alloc(sizeof (string_slice), 0);
+  res->length = length;
+  res->tag = STRING_SLICE;
+  res->buffer = buffer;
+  return (const char *) &res->buffer;
+}
+
+/* The strings of a single character, and the empty string. */
+typedef struct char_string
+{
+  int32_t length;
+  char chars[4];
+} char_string;
+
+// This is filled in tc_runtime_init.
+static char_string consts[256];
+static char_string empty = { 0, "" };
+
+/** \brief Make a string.
+    \param chars   Its characters.
+    \param length  Their number.
+
+    For the string literals of the programs run by tc.
+*/
+const char *tc_string(const char *chars, int length)
+{
+  char *res = string_new(length);
+  memcpy(res, chars, length);
+  return res;
+}
 
 /** \brief Get a string containing the character represented by the ascii value
  *         of \a i.
@@ -64,11 +667,8 @@ static char consts[512] = { 0 };
 const char *tc_chr(int i)
 {
   if (!(0 <= i && i <= 255))
-  {
-    fputs("chr: character out of range\n", stderr);
-    exit(EXIT_RUNTIME_FAILURE);
-  }
-  return consts + i * 2;
+    tc_runtime_failure("chr: character out of range");
+  return consts[i].chars;
 }
 
 /** \brief Concatenate two strings.
@@ -77,24 +677,42 @@ const char *tc_chr(int i)
 */
 const char *tc_concat(const char *a, const char *b)
 {
-  size_t len_a = strlen(a);
-  size_t len_b = strlen(b);
+  int32_t len_a = string_length(a);
+  int32_t len_b = string_length(b);
   if (len_a == 0)
     return b;
   else if (len_b == 0)
     return a;
-  else
+  else if (len_a > INT32_MAX - len_b)
+    tc_runtime_failure("concat: string too long");
+
+  int32_t n = len_a + len_b;
+  if (n <= STRING_FLAT_MAX)
   {
-    int i = 0;
-    int n = len_a + len_b;
-    char *t = (char *) malloc(n + 1);
-    for (i = 0; i < len_a; i++)
-      t[i] = a[i];
-    for (i = 0; i < len_b; i++)
-      t[i + len_a] = b[i];
-    t[n] = '\0';
+    char *t = string_new(n);
+    memcpy(t, string_chars(a), len_a);
+    memcpy(t + len_a, string_chars(b), len_b);
     return t;
   }
+
+  // Append in place if \a a ends the buffer, and b fits.  \a b may be
+  // a slice of the same buffer: it is not overwritten.
+  string_slice *slice = string_slice_of(a);
+  string_buffer *buffer = slice ? slice->buffer : NULL;
+  if (!(buffer
+        && buffer->used == len_a
+        && len_b <= buffer->capacity - len_a))
+  {
+    size_t capacity = 2 * (size_t) n;
+    if (capacity > INT32_MAX)
+      capacity = INT32_MAX;
+    buffer = runtime_alloc(sizeof (string_buffer) + capacity, 1);
+    buffer->capacity = capacity;
+    memcpy(buffer->chars, string_chars(a), len_a);
+  }
+  memcpy(buffer->chars + len_a, string_chars(b), len_b);
+  buffer->used = n;
+  return string_slice_new(buffer, n);
 }
 
 /** \brief Get the ascii value of a character.
@@ -104,11 +722,10 @@ const char *tc_concat(const char *a, const char *b)
 */
 int tc_ord(const char *s)
 {
-  size_t len = strlen(s);
-  if (len == 0)
+  if (string_length(s) == 0)
     return -1;
   else
-    return s[0];
+    return string_chars(s)[0];
 }
 
 /** \brief Get the size of a string.
@@ -116,7 +733,7 @@ int tc_ord(const char *s)
 */
 int tc_size(const char *s)
 {
-  return strlen(s);
+  return string_length(s);
 }
 
 /** \brief Return a part of the string \a s.
@@ -129,23 +746,22 @@ int tc_size(const char *s)
 */
 const char *tc_substring(const char *s, int first, int n)
 {
-  size_t len = strlen(s);
+  int32_t len = string_length(s);
   if (!(0 <= first
         && 0 <= n
-        && first + n <= len))
-  {
-    fputs("substring: arguments out of bounds\n", stderr);
-    exit(EXIT_RUNTIME_FAILURE);
-  }
+        && n <= len - first))
+    tc_runtime_failure("substring: arguments out of bounds");
 
-  if (n == 1)
-    return consts + s[first] * 2;
+  if (n == 0)
+    return empty.chars;
+  else if (n == 1)
+    return consts[(unsigned char) string_chars(s)[first]].chars;
+  else if (n == len)
+    return s;
   else
   {
-    char *t = (char *) malloc(n + 1);
-    for (int i = 0; i < n; i++)
-      t[i] = s[first + i];
-    t[n] = '\0';
+    char *t = string_new(n);
+    memcpy(t, string_chars(s) + first, n);
     return t;
   }
 }
@@ -156,35 +772,110 @@ const char *tc_substring(const char *s, int first, int n)
 */
 int tc_strcmp(const char *lhs, const char *rhs)
 {
-  return strcmp(lhs, rhs);
+  if (lhs == rhs)
+    return 0;
+  int32_t len_lhs = string_length(lhs);
+  int32_t len_rhs = string_length(rhs);
+  int res = memcmp(string_chars(lhs), string_chars(rhs),
+                   len_lhs < len_rhs ? len_lhs : len_rhs);
+  if (res)
+    return res;
+  return (len_lhs > len_rhs) - (len_lhs < len_rhs);
 }
 
-/** \brief Return a part of the string \a s.
-    \param s       The source string
-    \param first   The first character of the extraction (starting at 0)
-    \param n       The number of characters to get.
-
-    \a first and \a n must be positive, and one shall not go beyond the size
-    of \a s.  Otherwise, exit with runtime failure.
+/** \brief Whether two strings are equal.
+    \param lhs       The first string.
+    \param rhs       The second string.
 */
 int tc_streq(const char *lhs, const char *rhs)
 {
-  return strcmp(lhs, rhs) == 0;
+  if (lhs == rhs)
+    return 1;
+  int32_t len = string_length(lhs);
+  return len == string_length(rhs)
+    && memcmp(string_chars(lhs), string_chars(rhs), len) == 0;
 }
 /** \} */
 
 /** \name Input/Output. */
 /** \{ */
 
+/* The standard output is buffered by the runtime, and written when the
+   buffer is full, by tc_flush, and at exit.  When it is a terminal,
+   it is also written at the end of each line, and before reading the
+   standard input.  The standard input is read by blocks.  */
+
+/* The size of the buffers, in bytes. */
+#define IO_BUFFER_SIZE (1 << 16)
+
+static struct
+{
+  char chars[IO_BUFFER_SIZE];
+  size_t length;
+  /* Whether to write the buffer at the end of each line. */
+  int line_buffered;
+} output;
+
+static struct
+{
+  char chars[IO_BUFFER_SIZE];
+  size_t begin;
+  size_t end;
+} input;
+
+/* Write the output buffer. */
+static void output_flush(void)
+{
+  fwrite(output.chars, 1, output.length, stdout);
+  output.length = 0;
+  fflush(stdout);
+}
+
+/* Append the \a n bytes of \a chars to the output. */
+static void output_write(const char *chars, size_t n)
+{
+  if (IO_BUFFER_SIZE - output.length < n)
+  {
+    output_flush();
+    if (IO_BUFFER_SIZE < n)
+    {
+      fwrite(chars, 1, n, stdout);
+      fflush(stdout);
+      return;
+    }
+  }
+  memcpy(output.chars + output.length, chars, n);
+  output.length += n;
+  if (output.line_buffered && memchr(chars, '\n', n))
+    output_flush();
+}
+
+/** \brief Report a runtime failure and exit, the output being flushed.
+*/
+void tc_runtime_failure(const char *message)
+{
+  output_flush();
+  fputs(message, stderr);
+  fputc('\n', stderr);
+  exit(EXIT_RUNTIME_FAILURE);
+}
+
 /** \brief Get a character from the standard input.
 */
 const char *tc_getchar()
 {
-  int i = getc(stdin);
-  if (i == EOF)
-    return "";
-  else
-    return consts + i * 2;
+  if (input.begin == input.end)
+  {
+    // Show the prompt, as the C library does for terminals.
+    if (output.line_buffered)
+      output_flush();
+    ssize_t n = read(STDIN_FILENO, input.chars, IO_BUFFER_SIZE);
+    input.begin = 0;
+    input.end = n < 0 ? 0 : n;
+    if (input.begin == input.end)
+      return empty.chars;
+  }
+  return consts[(unsigned char) input.chars[input.begin++]].chars;
 }
 
 /** \brief Print a string on the standard output.
@@ -192,7 +883,7 @@ const char *tc_getchar()
 */
 void tc_print(const char *s)
 {
-  printf("%s", s);
+  output_write(string_chars(s), string_length(s));
 }
 
 /** \brief Print a string on the standard error.
@@ -200,7 +891,7 @@ void tc_print(const char *s)
 */
 void tc_print_err(const char *s)
 {
-  fprintf(stderr, "%s", s);
+  fwrite(string_chars(s), 1, string_length(s), stderr);
 }
 
 /** \brief Print an int on the standard error.
@@ -208,28 +899,61 @@ void tc_print_err(const char *s)
 */
 void tc_print_int(int i)
 {
-  printf("%d", i);
+  // The digits, from the end, of at most 10 digits and a sign.
+  char buf[11];
+  char *p = buf + sizeof buf;
+  // Negated as an unsigned, INT_MIN has an absolute value too.
+  uint32_t u = i < 0 ? 0u - (uint32_t) i : (uint32_t) i;
+  do
+  {
+    *--p = '0' + u % 10;
+    u /= 10;
+  } while (u);
+  if (i < 0)
+    *--p = '-';
+  output_write(p, buf + sizeof buf - p);
 }
 
 /** \brief Flush the standard output.
 */
 void tc_flush()
 {
-  fflush(stdout);
+  output_flush();
 }
 
 /** \} */
 
-int main()
+void tc_runtime_init(void)
 {
-  // Fill the `consts` array with every character in the ascii table, followed
-  // by a null character.
-  for (int i = 0; i < 512; i += 2)
+  // The runtime embedded in tc may run several programs: make the heap
+  // of the previous one walkable, and disable its collector.
+  if (gc.stack_base)
   {
-    consts[i] = i / 2;
-    consts[i + 1] = 0;
+    gc_retire();
+    gc.stack_base = NULL;
   }
 
+  output.length = 0;
+  output.line_buffered = isatty(STDOUT_FILENO);
+  input.begin = input.end = 0;
+
+  // Fill the `consts` array with a string for every character in the
+  // ascii table.
+  for (int i = 0; i < 256; ++i)
+  {
+    consts[i].length = 1;
+    consts[i].chars[0] = i;
+    consts[i].chars[1] = '\0';
+  }
+}
+
+// When embedded in tc, there is no tc_main to run.
+#ifndef TC_RUNTIME_EMBEDDED
+int main()
+{
+  tc_runtime_init();
   tc_main(0);
+  tc_flush();
   return 0;
 }
+#endif
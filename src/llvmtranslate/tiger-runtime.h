@@ -0,0 +1,67 @@
+/**
+   \file llvmtranslate/tiger-runtime.h
+   \brief Interface of the Tiger runtime.
+
+   The runtime is linked with the compiled programs, and embedded in tc
+   for the programs it runs itself.
+
+   A string is the address of its characters, followed by a NUL, and
+   preceded by their number as a 32-bit integer: tc_string makes one.
+   The long concatenations make slices of growing buffers instead, only
+   known to the runtime.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined __cplusplus
+#  define TC_NORETURN [[noreturn]]
+#elif defined __GNUC__
+#  define TC_NORETURN __attribute__((noreturn))
+#else
+#  define TC_NORETURN
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Set the runtime up.  Called by main before tc_main. */
+void tc_runtime_init(void);
+
+/** \name Internal functions (calls generated by the compiler only). */
+/** \{ */
+extern char *tc_alloc_cursor;
+extern char *tc_alloc_limit;
+void *tc_alloc(int size);
+const char *tc_string(const char *chars, int length);
+void tc_gc_init(void *stack_base);
+void *tc_init_array(int size, int elt_size, int64_t elt);
+/** \} */
+
+/** \brief Report a runtime failure and exit, the output being flushed.
+    Also used by tc for the programs it runs itself. */
+TC_NORETURN void tc_runtime_failure(const char *message);
+
+/** \name Primitives of the prelude. */
+/** \{ */
+int tc_not(int i);
+void tc_exit(int status);
+const char *tc_chr(int i);
+const char *tc_concat(const char *a, const char *b);
+int tc_ord(const char *s);
+int tc_size(const char *s);
+const char *tc_substring(const char *s, int first, int n);
+int tc_strcmp(const char *lhs, const char *rhs);
+int tc_streq(const char *lhs, const char *rhs);
+const char *tc_getchar(void);
+void tc_print(const char *s);
+void tc_print_err(const char *s);
+void tc_print_int(int i);
+void tc_flush(void);
+/** \} */
+
+#ifdef __cplusplus
+}
+#endif
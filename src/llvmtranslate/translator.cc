@@ -8,7 +8,10 @@
 
 #include <llvm/ADT/Triple.h>
 #include <llvm/Config/llvm-config.h> // LLVM_VERSION_*
+#include <llvm/IR/CFG.h> // llvm::predecessors
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h> // llvm::verifyFunction
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/Host.h> // llvm::sys
@@ -17,6 +20,7 @@
 
 #include <ast/all.hh>
 #include <llvmtranslate/translator.hh>
+#include <misc/contract.hh>
 
 namespace llvmtranslate
 {
@@ -35,6 +39,10 @@ namespace llvmtranslate
       return llvm::Type::getInt32PtrTy(ctx);
     }
 
+    // The unit of allocation of the runtime, which is also the size of
+    // the header of the objects of the collector.
+    constexpr unsigned alloc_granule = 8;
+
     llvm::AllocaInst* create_alloca(llvm::Function* ll_function,
                                     llvm::Type* ll_type,
                                     const std::string& name)
@@ -56,6 +64,23 @@ namespace llvmtranslate
         the_function.addFnAttr(llvm::Attribute::InlineHint);
     }
 
+    // Whether \a oper is a comparison, whose result is an i1.
+    bool is_comparison(ast::OpExp::Oper oper)
+    {
+      switch (oper)
+        {
+        case ast::OpExp::Oper::eq:
+        case ast::OpExp::Oper::ne:
+        case ast::OpExp::Oper::lt:
+        case ast::OpExp::Oper::le:
+        case ast::OpExp::Oper::gt:
+        case ast::OpExp::Oper::ge:
+          return true;
+        default:
+          return false;
+        }
+    }
+
     std::string function_dec_name(const ast::FunctionDec& e)
     {
       // Rename "_main" to "tc_main"
@@ -68,17 +93,23 @@ namespace llvmtranslate
     }
   } // namespace
 
-  Translator::Translator(llvm::Module& module, escaped_map_type&& escaped)
+  Translator::Translator(llvm::Module& module,
+                         escaped_map_type&& escaped,
+                         bool gc,
+                         bool target_64)
     : module_{module}
     , ctx_{module_.getContext()}
     , builder_{ctx_}
     , escaped_{std::move(escaped)}
     , type_visitor_{ctx_}
+    , gc_{gc}
   {
     // The current process triple.
     auto process_triple = llvm::Triple(llvm::sys::getProcessTriple());
-    // Set the 32-bit version of the triple.
-    module_.setTargetTriple(process_triple.get32BitArchVariant().str());
+    // Set the 32-bit or 64-bit version of the triple.
+    module_.setTargetTriple(target_64
+                              ? process_triple.get64BitArchVariant().str()
+                              : process_triple.get32BitArchVariant().str());
   }
 
   void Translator::operator()(const ast::Ast& e)
@@ -87,19 +118,39 @@ namespace llvmtranslate
     value_ = nullptr;
   }
 
+  void Translator::translate_partition(const function_decs_type& bodies)
+  {
+    partitioned_ = true;
+    for (const ast::FunctionDec* fdec : bodies)
+      visit_function_dec_body(*fdec);
+    value_ = nullptr;
+  }
+
   llvm::Value* Translator::translate(const ast::Ast& node)
   {
     node.accept(*this);
     return value_;
   }
 
+  llvm::Function* Translator::function_get(const ast::FunctionDec& e)
+  {
+    // The functions of a partition are declared when they are used.
+    auto the_function = module_.getFunction(function_dec_name(e));
+    if (!the_function && partitioned_)
+      {
+        visit_function_dec_header(e);
+        the_function = module_.getFunction(function_dec_name(e));
+      }
+    return the_function;
+  }
+
   llvm::Value* Translator::access_var(const ast::Var& e)
   {
     if (auto var_ast = dynamic_cast<const ast::SimpleVar*>(&e))
       {
+        precondition(!is_ssa(*var_ast->def_get()));
         // FIXED: Some code was deleted here.
-        llvm::Value* def = locals_[current_function_][var_ast->def_get()];
-        return def;
+        return function_.locals.lookup(var_ast->def_get());
       }
 
     else if (auto arr_ast = dynamic_cast<const ast::SubscriptVar*>(&e))
@@ -152,44 +203,240 @@ namespace llvmtranslate
       unreachable();
   }
 
+  llvm::Type* Translator::var_ltype(const ast::VarDec& var)
+  {
+    // Void var types are actually Ints represented by a 0
+    if (dynamic_cast<const type::Void*>(var.type_get()))
+      return i32_t(ctx_);
+    return llvm_type(*var.type_get());
+  }
+
+  void Translator::var_write(const ast::VarDec& var,
+                             llvm::BasicBlock* bb,
+                             llvm::Value* val)
+  {
+    function_.current_def[{&var, bb}] = val;
+  }
+
+  llvm::Value* Translator::var_read(const ast::VarDec& var,
+                                    llvm::BasicBlock* bb)
+  {
+    if (auto def = function_.current_def.find({&var, bb});
+        def != function_.current_def.end())
+      return def->second;
+    return var_read_recursive(var, bb);
+  }
+
+  llvm::Value* Translator::var_read_recursive(const ast::VarDec& var,
+                                              llvm::BasicBlock* bb)
+  {
+    llvm::Value* res = nullptr;
+    if (auto incomplete = function_.incomplete_phis.find(bb);
+        incomplete != function_.incomplete_phis.end())
+      {
+        // A loop head: its operands are known once the loop is.
+        auto phi = phi_create(var, bb);
+        incomplete->second.emplace_back(&var, phi);
+        res = phi;
+      }
+    else if (auto pred = bb->getUniquePredecessor())
+      // No phi is needed.
+      res = var_read(var, pred);
+    else
+      {
+        // Define the phi before reading its operands, so that the
+        // cycles of the control flow end on it.
+        auto phi = phi_create(var, bb);
+        var_write(var, bb, phi);
+        res = phi_operands_add(var, phi);
+      }
+    var_write(var, bb, res);
+    return res;
+  }
+
+  llvm::PHINode* Translator::phi_create(const ast::VarDec& var,
+                                        llvm::BasicBlock* bb)
+  {
+    // The phis come first in their block.
+    llvm::IRBuilder<> tmp(bb, bb->begin());
+    return tmp.CreatePHI(var_ltype(var), 0, var.name_get().get());
+  }
+
+  llvm::Value* Translator::phi_operands_add(const ast::VarDec& var,
+                                            llvm::PHINode* phi)
+  {
+    // One operand per edge, as some predecessors may branch twice.
+    llvm::SmallVector<llvm::BasicBlock*, 4> preds(
+      llvm::predecessors(phi->getParent()));
+
+    // Read them all before adding them: an incomplete phi could be
+    // found trivial when the phis it uses are.  The handles follow the
+    // phis removed meanwhile.
+    llvm::SmallVector<llvm::WeakTrackingVH, 4> vals;
+    for (auto pred : preds)
+      vals.emplace_back(var_read(var, pred));
+    for (unsigned i = 0; i < preds.size(); ++i)
+      phi->addIncoming(vals[i], preds[i]);
+    return phi_trivial_remove(phi);
+  }
+
+  llvm::Value* Translator::phi_trivial_remove(llvm::PHINode* phi)
+  {
+    // The undefined values, from the unreachable blocks, e.g., after a
+    // break, may be any value: they are merged with the others.
+    llvm::Value* same = nullptr;
+    for (llvm::Value* op : phi->incoming_values())
+      {
+        if (op == same || op == phi || llvm::isa<llvm::UndefValue>(op))
+          continue;
+        // The phi merges at least two values.
+        if (same)
+          return phi;
+        same = op;
+      }
+    // Only the unreachable blocks have no definition.
+    if (!same)
+      same = llvm::UndefValue::get(phi->getType());
+
+    // The phis using this one may become trivial too.  They may also be
+    // removed meanwhile, which nulls their handle.
+    llvm::SmallVector<llvm::WeakVH, 4> users;
+    for (llvm::User* user : phi->users())
+      if (user != phi && llvm::isa<llvm::PHINode>(user))
+        users.emplace_back(user);
+
+    phi->replaceAllUsesWith(same);
+    phi->eraseFromParent();
+
+    // The replacement itself may be one of these phis.
+    llvm::WeakTrackingVH res = same;
+    for (llvm::Value* user : users)
+      if (user)
+        phi_trivial_remove(llvm::cast<llvm::PHINode>(user));
+    return res;
+  }
+
+  void Translator::block_seal(llvm::BasicBlock* bb)
+  {
+    auto incomplete = std::move(function_.incomplete_phis[bb]);
+    function_.incomplete_phis.erase(bb);
+    for (auto [var, phi] : incomplete)
+      phi_operands_add(*var, phi);
+  }
+
   llvm::Value* Translator::init_array(llvm::Value* count_val,
                                       llvm::Value* init_val)
   {
     // Cast everything so that it is conform to the signature of init_array
-    // int *init_array(int, int)
-
-    // We need to separate the pointers and the ints.
-    // LLVM requires a ptrtoint instruction for pointers
-    // and a bitcast for others.
-    auto init_val_cast = init_val->getType()->isPointerTy()
-      ? builder_.CreatePtrToInt(init_val, i32_t(ctx_), "init_array_ptrtoint")
-      : builder_.CreateBitCast(init_val, i32_t(ctx_), "init_array_bitcast");
+    // void *init_array(int size, int elt_size, int64_t elt)
+
+    // The elements are pointer-sized for arrays of pointers, and the
+    // default element is passed whole, extended to 64 bits.
+    llvm::Type* elt_ltype = init_val->getType();
+    llvm::Type* i64_t = builder_.getInt64Ty();
+    auto init_val_cast = elt_ltype->isPointerTy()
+      ? builder_.CreatePtrToInt(init_val, i64_t, "init_array_ptrtoint")
+      : builder_.CreateSExt(init_val, i64_t, "init_array_sext");
+    llvm::Constant* elt_size_val = llvm::ConstantExpr::getTruncOrBitCast(
+      llvm::ConstantExpr::getSizeOf(elt_ltype), i32_t(ctx_));
 
     // Create the init_array function:
-    // First, the arguments (int*, int, int)
-    std::vector<llvm::Type*> arg_type{i32_t(ctx_), init_val_cast->getType()};
+    // First, the arguments (int, int, int64_t)
+    std::vector<llvm::Type*> arg_type{i32_t(ctx_), i32_t(ctx_), i64_t};
 
     // Then, create the FunctionType.
     auto init_array_ltype =
-      llvm::FunctionType::get(i32p_t(ctx_), arg_type, false);
+      llvm::FunctionType::get(builder_.getInt8PtrTy(), arg_type, false);
 
     // Get the llvm::Function from the module related to the name and type
     auto init_array_function =
       module_.getOrInsertFunction("tc_init_array", init_array_ltype);
 
     // Prepare the arguments.
-    std::vector<llvm::Value*> arg_vals{count_val, init_val_cast};
+    std::vector<llvm::Value*> arg_vals{count_val, elt_size_val, init_val_cast};
 
     // Create the call.
     auto init_array_call =
       builder_.CreateCall(init_array_function, arg_vals, "init_array_call");
 
     // Cast the result of the call in the desired type.
-    return builder_.CreateBitCast(init_array_call,
-                                  init_val->getType()->getPointerTo(),
+    return builder_.CreateBitCast(init_array_call, elt_ltype->getPointerTo(),
                                   "init_array_call_cast");
   }
 
+  llvm::Value* Translator::record_alloc(llvm::Type* struct_ltype,
+                                        bool empty)
+  {
+    // The size of the structure and cast it to int.  Empty records take
+    // a byte, to be distinct.
+    llvm::Constant* size_val = empty
+      ? builder_.getInt32(1)
+      : llvm::ConstantExpr::getTruncOrBitCast(
+        llvm::ConstantExpr::getSizeOf(struct_ltype), i32_t(ctx_));
+
+    // The size in the region, rounded as in the runtime, with the header
+    // of the collector if any.  This is folded into a constant.
+    llvm::Value* granules_val = builder_.CreateUDiv(
+      builder_.CreateAdd(size_val, builder_.getInt32(alloc_granule - 1)),
+      builder_.getInt32(alloc_granule));
+    if (gc_)
+      granules_val = builder_.CreateAdd(granules_val, builder_.getInt32(1));
+    llvm::Value* bytes_val =
+      builder_.CreateMul(granules_val, builder_.getInt32(alloc_granule));
+
+    // The current region, from the runtime.
+    auto i8p_t = builder_.getInt8PtrTy();
+    auto cursor_var = module_.getOrInsertGlobal("tc_alloc_cursor", i8p_t);
+    auto limit_var = module_.getOrInsertGlobal("tc_alloc_limit", i8p_t);
+
+    auto fast_bb =
+      llvm::BasicBlock::Create(ctx_, "alloc_fast", current_function_);
+    auto slow_bb =
+      llvm::BasicBlock::Create(ctx_, "alloc_slow", current_function_);
+    auto end_bb = llvm::BasicBlock::Create(ctx_, "alloc_end", current_function_);
+
+    // Bump the pointer if the record fits in the region.
+    auto cursor_val = builder_.CreateLoad(i8p_t, cursor_var, "alloc_cursor");
+    auto next_val = builder_.CreateGEP(builder_.getInt8Ty(), cursor_val,
+                                       bytes_val, "alloc_next");
+    auto limit_val = builder_.CreateLoad(i8p_t, limit_var, "alloc_limit");
+    builder_.CreateCondBr(
+      builder_.CreateICmpULE(next_val, limit_val, "alloc_fits"), fast_bb,
+      slow_bb, llvm::MDBuilder(ctx_).createBranchWeights(1000, 1));
+
+    builder_.SetInsertPoint(fast_bb);
+    builder_.CreateStore(next_val, cursor_var);
+    llvm::Value* fast_val = cursor_val;
+    if (gc_)
+      {
+        // The header of the collector: the size in granules, no flags.
+        auto header_val =
+          builder_.CreateBitCast(cursor_val, i32p_t(ctx_), "alloc_header");
+        builder_.CreateStore(granules_val, header_val);
+        builder_.CreateStore(
+          builder_.getInt32(0),
+          builder_.CreateConstGEP1_32(i32_t(ctx_), header_val, 1));
+        fast_val = builder_.CreateConstGEP1_32(
+          builder_.getInt8Ty(), cursor_val, alloc_granule, "alloc_object");
+      }
+    builder_.CreateBr(end_bb);
+
+    // Otherwise, let the runtime find a new region: void* tc_alloc(int).
+    builder_.SetInsertPoint(slow_bb);
+    auto alloc_function = module_.getOrInsertFunction(
+      "tc_alloc", llvm::FunctionType::get(i8p_t, {i32_t(ctx_)}, false));
+    auto slow_val =
+      builder_.CreateCall(alloc_function, {size_val}, "alloc_call");
+    builder_.CreateBr(end_bb);
+
+    builder_.SetInsertPoint(end_bb);
+    auto record_val = builder_.CreatePHI(i8p_t, 2, "alloc");
+    record_val->addIncoming(fast_val, fast_bb);
+    record_val->addIncoming(slow_val, slow_bb);
+    return builder_.CreateBitCast(record_val, struct_ltype->getPointerTo(),
+                                  "malloccall");
+  }
+
   llvm::Type* Translator::llvm_type(const type::Type& type)
   {
     type_visitor_(type);
@@ -242,6 +489,13 @@ namespace llvmtranslate
 
   void Translator::operator()(const ast::SimpleVar& e)
   {
+    // The variables in SSA form are not in memory.
+    if (is_ssa(*e.def_get()))
+      {
+        value_ = var_read(*e.def_get(), builder_.GetInsertBlock());
+        return;
+      }
+
     // Void var types are actually Ints represented by a 0
     // FIXED: Some code was deleted here.
     if (dynamic_cast<const type::Void*>(e.type_get()))
@@ -299,7 +553,21 @@ namespace llvmtranslate
   void Translator::operator()(const ast::StringExp& e)
   {
     // FIXED: Some code was deleted here (Strings are translated as `i8*` values, like C's `char*`).
-    value_ = builder_.CreateGlobalStringPtr(e.value_get(), "string");
+    // The characters are preceded by their number, as in the runtime.
+    const std::string& chars = e.value_get();
+    auto string_val = llvm::ConstantStruct::getAnon(
+      {builder_.getInt32(chars.size()),
+       llvm::ConstantDataArray::getString(ctx_, chars, true)});
+    auto string_var = new llvm::GlobalVariable(
+      module_, string_val->getType(), true, llvm::GlobalValue::PrivateLinkage,
+      string_val, "string");
+    string_var->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    string_var->setAlignment(llvm::Align(4));
+    value_ = llvm::ConstantExpr::getInBoundsGetElementPtr(
+      string_val->getType(), string_var,
+      llvm::ArrayRef<llvm::Constant*>{builder_.getInt32(0),
+                                      builder_.getInt32(1),
+                                      builder_.getInt32(0)});
   }
 
   void Translator::operator()(const ast::RecordExp& e)
@@ -313,20 +581,8 @@ namespace llvmtranslate
     llvm_type(*record_type);
     auto struct_ltype = type_visitor_.get_record_ltype(record_type);
 
-    // The current basic block
-    auto current_bb = builder_.GetInsertBlock();
-
-    // The size of the structure and cast it to int
-    auto sizeof_val = llvm::ConstantExpr::getSizeOf(struct_ltype);
-    sizeof_val = llvm::ConstantExpr::getTruncOrBitCast(sizeof_val, i32_t(ctx_));
-
-    // Generate the instruction calling Malloc
-    auto malloc_val =
-      llvm::CallInst::CreateMalloc(current_bb, i32_t(ctx_), struct_ltype,
-                                   sizeof_val, nullptr, nullptr, "malloccall");
-
-    // Add it using the IR builder
-    builder_.Insert(malloc_val, "malloccall");
+    // Allocate it in the region of the runtime
+    auto malloc_val = record_alloc(struct_ltype, e.fields_get().empty());
 
     // Init the fields
     // FIXED: Some code was deleted here.
@@ -341,8 +597,116 @@ namespace llvmtranslate
     value_ = malloc_val;
   }
 
+  llvm::Value* Translator::translate_comparison(const ast::OpExp& e)
+  {
+    llvm::Value* l_val = translate(e.left_get());
+    llvm::Value* r_val = translate(e.right_get());
+
+    switch (e.oper_get())
+      {
+      case ast::OpExp::Oper::eq:
+        return builder_.CreateICmpEQ(l_val, r_val, "eqtmp");
+      case ast::OpExp::Oper::ne:
+        return builder_.CreateICmpNE(l_val, r_val, "netmp");
+      case ast::OpExp::Oper::lt:
+        return builder_.CreateICmpSLT(l_val, r_val, "lttmp");
+      case ast::OpExp::Oper::le:
+        return builder_.CreateICmpSLE(l_val, r_val, "letmp");
+      case ast::OpExp::Oper::gt:
+        return builder_.CreateICmpSGT(l_val, r_val, "gttmp");
+      case ast::OpExp::Oper::ge:
+        return builder_.CreateICmpSGE(l_val, r_val, "getmp");
+      default:
+        unreachable();
+      }
+  }
+
+  void Translator::translate_condition(const ast::Exp& e,
+                                       llvm::BasicBlock* true_bb,
+                                       llvm::BasicBlock* false_bb)
+  {
+    // A constant test, e.g., from the desugared `&' and `|'.
+    if (auto int_exp = dynamic_cast<const ast::IntExp*>(&e))
+      {
+        builder_.CreateBr(int_exp->value_get() ? true_bb : false_bb);
+        return;
+      }
+
+    if (auto op_exp = dynamic_cast<const ast::OpExp*>(&e);
+        op_exp && is_comparison(op_exp->oper_get()))
+      {
+        // `exp <> 0' and `exp = 0', e.g., from the desugared `&' and `|':
+        // test exp itself.
+        auto zero = dynamic_cast<const ast::IntExp*>(&op_exp->right_get());
+        if (zero && !zero->value_get()
+            && op_exp->oper_get() == ast::OpExp::Oper::ne)
+          translate_condition(op_exp->left_get(), true_bb, false_bb);
+        else if (zero && !zero->value_get()
+                 && op_exp->oper_get() == ast::OpExp::Oper::eq)
+          translate_condition(op_exp->left_get(), false_bb, true_bb);
+        else
+          builder_.CreateCondBr(translate_comparison(*op_exp), true_bb,
+                                false_bb);
+        return;
+      }
+
+    // `if a then b else c' is true if a and b are, or if c is: branch on
+    // b or c, as `&' and `|' are desugared.
+    if (auto if_exp = dynamic_cast<const ast::IfExp*>(&e);
+        if_exp && !dynamic_cast<const type::Void*>(e.type_get()))
+      {
+        // The constant clauses, as in the desugared `&' and `|', branch
+        // to their target directly.
+        auto clause_bb = [&](const ast::Exp& clause, const char* name) {
+          auto int_exp = dynamic_cast<const ast::IntExp*>(&clause);
+          if (int_exp)
+            return int_exp->value_get() ? true_bb : false_bb;
+          return llvm::BasicBlock::Create(ctx_, name);
+        };
+        auto clause_translate = [&](const ast::Exp& clause,
+                                    llvm::BasicBlock* bb) {
+          if (dynamic_cast<const ast::IntExp*>(&clause))
+            return;
+          current_function_->getBasicBlockList().push_back(bb);
+          builder_.SetInsertPoint(bb);
+          translate_condition(clause, true_bb, false_bb);
+        };
+
+        auto then_bb = clause_bb(if_exp->thenclause_get(), "cond_then");
+        auto else_bb = clause_bb(if_exp->elseclause_get(), "cond_else");
+        translate_condition(if_exp->test_get(), then_bb, else_bb);
+        clause_translate(if_exp->thenclause_get(), then_bb);
+        clause_translate(if_exp->elseclause_get(), else_bb);
+        return;
+      }
+
+    // Test the last expression of a sequence.
+    if (auto seq_exp = dynamic_cast<const ast::SeqExp*>(&e);
+        seq_exp && !seq_exp->exps_get().empty())
+      {
+        auto& exps = seq_exp->exps_get();
+        for (auto exp = exps.begin(); std::next(exp) != exps.end(); ++exp)
+          translate(**exp);
+        translate_condition(*exps.back(), true_bb, false_bb);
+        return;
+      }
+
+    builder_.CreateCondBr(
+      builder_.CreateICmpNE(translate(e), builder_.getInt32(0), "cond"),
+      true_bb, false_bb);
+  }
+
   void Translator::operator()(const ast::OpExp& e)
   {
+    // The comparisons return an i1, and we need an i32, since everything
+    // is an i32 in Tiger. Use a zero-extension to avoid this.
+    if (is_comparison(e.oper_get()))
+      {
+        value_ =
+          builder_.CreateZExt(translate_comparison(e), i32_t(ctx_), "op_zext");
+        return;
+      }
+
     // FIXED: Some code was deleted here.
     llvm::Value* l_val = translate(e.left_get());
     llvm::Value* r_val = translate(e.right_get());
@@ -361,31 +725,9 @@ namespace llvmtranslate
       case ast::OpExp::Oper::div:
         value_ = builder_.CreateSDiv(l_val, r_val, "divtmp");
         break;
-      case ast::OpExp::Oper::eq:
-        value_ = builder_.CreateICmpEQ(l_val, r_val, "eqtmp");
-        break;
-      case ast::OpExp::Oper::ne:
-        value_ = builder_.CreateICmpNE(l_val, r_val, "netmp");
-        break;
-      case ast::OpExp::Oper::lt:
-        value_ = builder_.CreateICmpSLT(l_val, r_val, "lttmp");
-        break;
-      case ast::OpExp::Oper::le:
-        value_ = builder_.CreateICmpSLE(l_val, r_val, "letmp");
-        break;
-      case ast::OpExp::Oper::gt:
-        value_ = builder_.CreateICmpSGT(l_val, r_val, "gttmp");
-        break;
-      case ast::OpExp::Oper::ge:
-        value_ = builder_.CreateICmpSGE(l_val, r_val, "getmp");
-        break;
       default:
-        break;
+        unreachable();
       }
-
-    // The comparison instructions returns an i1, and we need an i32, since everything
-    // is an i32 in Tiger. Use a zero-extension to avoid this.
-    value_ = builder_.CreateZExtOrTrunc(value_, i32_t(ctx_), "op_zext");
   }
 
   void Translator::operator()(const ast::SeqExp& e)
@@ -407,8 +749,18 @@ namespace llvmtranslate
   {
     // FIXED: Some code was deleted here.
     auto value = translate(e.exp_get());
-    auto var = access_var(e.var_get());
-    builder_.CreateStore(value, var);
+    auto var_ast = dynamic_cast<const ast::SimpleVar*>(&e.var_get());
+    if (var_ast && is_ssa(*var_ast->def_get()))
+      {
+        if (dynamic_cast<const type::Void*>(var_ast->type_get()))
+          value = builder_.getInt32(0);
+        var_write(*var_ast->def_get(), builder_.GetInsertBlock(), value);
+      }
+    else
+      {
+        auto var = access_var(e.var_get());
+        builder_.CreateStore(value, var);
+      }
 
     value_ = llvm::ConstantInt::get(i32_t(ctx_), 0);
   }
@@ -417,17 +769,15 @@ namespace llvmtranslate
   {
     // FIXED: Some code was deleted here (IfExps are handled in a similar way to Kaleidoscope (see LangImpl5.html)).
 
-    llvm::Value* condv = builder_.CreateICmpNE(translate(e.test_get()),
-                                               builder_.getInt32(0), "ifcond");
-
     llvm::Function* TheFunction = builder_.GetInsertBlock()->getParent();
-    llvm::BasicBlock* ThenBB =
-      llvm::BasicBlock::Create(ctx_, "then", TheFunction);
+    llvm::BasicBlock* ThenBB = llvm::BasicBlock::Create(ctx_, "then");
     llvm::BasicBlock* ElseBB = llvm::BasicBlock::Create(ctx_, "else");
     llvm::BasicBlock* MergeBB = llvm::BasicBlock::Create(ctx_, "ifend");
 
-    builder_.CreateCondBr(condv, ThenBB, ElseBB);
+    // Branch on the test itself, not on its extension to an i32.
+    translate_condition(e.test_get(), ThenBB, ElseBB);
 
+    TheFunction->getBasicBlockList().push_back(ThenBB);
     builder_.SetInsertPoint(ThenBB);
 
     llvm::Value* ThenV = translate(e.thenclause_get());
@@ -464,35 +814,34 @@ namespace llvmtranslate
   {
     // Bb containing the test and the branching
     auto test_bb = llvm::BasicBlock::Create(ctx_, "test", current_function_);
-    auto body_bb = llvm::BasicBlock::Create(ctx_, "body", current_function_);
-    auto after_bb =
-      llvm::BasicBlock::Create(ctx_, "afterloop", current_function_);
+    auto body_bb = llvm::BasicBlock::Create(ctx_, "body");
+    auto after_bb = llvm::BasicBlock::Create(ctx_, "afterloop");
+
+    // The test block is not sealed until the body branches back to it.
+    function_.incomplete_phis.try_emplace(test_bb);
 
     // Save the after block for breaks
-    loop_end_[&e] = after_bb;
+    function_.loop_end[&e] = after_bb;
 
     // Explicitly fall through from the current block
     builder_.CreateBr(test_bb);
 
-    // Start inside the test BasicBlock
+    // Start inside the test BasicBlock, and branch on the test itself
     builder_.SetInsertPoint(test_bb);
-
-    auto cond_val = translate(e.test_get());
-    auto zero_val = llvm::ConstantInt::getSigned(cond_val->getType(), 0);
-    auto cmp_val = builder_.CreateICmpNE(cond_val, zero_val, "loopcond");
-
-    // Create the branching
-    builder_.CreateCondBr(cmp_val, body_bb, after_bb);
+    translate_condition(e.test_get(), body_bb, after_bb);
 
     // Translate the body inside the body BasicBlock
+    current_function_->getBasicBlockList().push_back(body_bb);
     builder_.SetInsertPoint(body_bb);
     // Don't store the return value, is should be void.
     translate(e.body_get());
 
     // Go back to the Test BasicBlock
     builder_.CreateBr(test_bb);
+    block_seal(test_bb);
 
     // Continue after the loop BasicBlock
+    current_function_->getBasicBlockList().push_back(after_bb);
     builder_.SetInsertPoint(after_bb);
   }
 
@@ -501,7 +850,12 @@ namespace llvmtranslate
     // FIXED: Some code was deleted here.
     auto block = e.def_get();
     value_ = builder_.CreateBr(
-      loop_end_[dynamic_cast<const ast::WhileExp*>(e.def_get())]);
+      function_.loop_end.lookup(
+        dynamic_cast<const ast::WhileExp*>(e.def_get())));
+
+    // What follows is unreachable, but must not follow the terminator.
+    builder_.SetInsertPoint(
+      llvm::BasicBlock::Create(ctx_, "afterbreak", current_function_));
 
     value_ = llvm::ConstantInt::get(i32_t(ctx_), 0);
   }
@@ -528,6 +882,11 @@ namespace llvmtranslate
 
   void Translator::operator()(const ast::FunctionChunk& e)
   {
+    // The functions of a partition are translated on their own, not
+    // where they are nested.
+    if (partitioned_)
+      return;
+
     for (const auto& fdec : e)
       visit_function_dec_header(*fdec);
 
@@ -550,12 +909,18 @@ namespace llvmtranslate
     auto function_ltype = llvm_function_type(function_type);
 
     // Main and primitives have External linkage.
-    // Other Tiger functions are treated as "static" functions in C.
-    auto linkage = is_main || is_primitive ? llvm::Function::ExternalLinkage
-                                           : llvm::Function::InternalLinkage;
+    // Other Tiger functions are treated as "static" functions in C,
+    // unless other partitions may call them: they are then hidden,
+    // until the partitions are linked together.
+    bool is_hidden = partitioned_ && !is_main && !is_primitive;
+    auto linkage = is_main || is_primitive || is_hidden
+      ? llvm::Function::ExternalLinkage
+      : llvm::Function::InternalLinkage;
 
     auto the_function =
       llvm::Function::Create(function_ltype, linkage, name, &module_);
+    if (is_hidden)
+      the_function->setVisibility(llvm::Function::HiddenVisibility);
     set_default_attributes(*the_function, e);
 
     auto& escaped = escaped_[&function_type];
@@ -575,18 +940,34 @@ namespace llvmtranslate
 
   void Translator::visit_function_dec_body(const ast::FunctionDec& e)
   {
-    auto the_function = module_.getFunction(function_dec_name(e));
+    auto the_function = function_get(e);
 
     // Save the old function in case a nested function occurs.
     auto old_insert_point = builder_.saveIP();
     auto old_function = current_function_;
     current_function_ = the_function;
+    auto old_state = std::exchange(function_, function_state());
 
     // Create a new basic block to start the function.
     auto bb = llvm::BasicBlock::Create(ctx_, "entry_"s + e.name_get().get(),
                                        the_function);
     builder_.SetInsertPoint(bb);
 
+    // The collector scans the stack up to the frame of the program.
+    if (gc_ && e.name_get() == "_main")
+      {
+        auto init_function = module_.getOrInsertFunction(
+          "tc_gc_init",
+          llvm::FunctionType::get(builder_.getVoidTy(),
+                                  {builder_.getInt8PtrTy()}, false));
+        auto frame_function = llvm::Intrinsic::getDeclaration(
+          &module_, llvm::Intrinsic::frameaddress, {builder_.getInt8PtrTy()});
+        builder_.CreateCall(init_function,
+                            {builder_.CreateCall(frame_function,
+                                                 {builder_.getInt32(0)},
+                                                 "frame")});
+      }
+
     const type::Type* node_type = nullptr;
     // FIXED: Some code was deleted here.
     node_type = e.type_get();
@@ -598,17 +979,23 @@ namespace llvmtranslate
 
     for (const auto var : escaped)
       {
-        locals_[current_function_][var] = &*arg_it;
+        function_.locals[var] = &*arg_it;
         ++arg_it;
       }
 
     // FIXED: Some code was deleted here (Create alloca instructions for each variable).
     for (const auto var : formals)
       {
+        if (is_ssa(*var))
+          {
+            var_write(*var, bb, &*arg_it);
+            ++arg_it;
+            continue;
+          }
         auto var_ltype = llvm_type(*var->type_get());
         auto val =
           builder_.CreateAlloca(var_ltype, nullptr, var->name_get().get());
-        locals_[current_function_][var] = val;
+        function_.locals[var] = val;
         builder_.CreateStore(&*arg_it, val);
         ++arg_it;
       }
@@ -628,7 +1015,9 @@ namespace llvmtranslate
     llvm::verifyFunction(*the_function);
 
     // Restore the context of the old function.
+    // Release the state of this function.
     current_function_ = old_function;
+    function_ = std::move(old_state);
     builder_.restoreIP(old_insert_point);
   }
 
@@ -642,7 +1031,7 @@ namespace llvmtranslate
     // FIXED: Some code was deleted here.
     std::string name = function_dec_name(*e.def_get());
     llvm::Type* callexptype = llvm_type(*e.type_get());
-    auto func = module_.getFunction(name);
+    auto func = function_get(*e.def_get());
     std::vector<llvm::Value*> arguments;
 
     const type::Type* node_type = e.def_get()->type_get();
@@ -652,7 +1041,7 @@ namespace llvmtranslate
 
     for (const auto var : escaped)
       {
-        arguments.push_back(locals_[current_function_][var]);
+        arguments.push_back(function_.locals.lookup(var));
       }
 
     for (const auto& a : e.args_get())
@@ -673,20 +1062,23 @@ namespace llvmtranslate
 
   void Translator::operator()(const ast::VarDec& e)
   {
-    // Void var types are actually Ints represented by a 0
-    // FIXED: Some code was deleted here.
-    if (dynamic_cast<const type::Void*>(e.type_get()))
-      {
-        value_ = builder_.CreateAlloca(llvm::Type::getInt32Ty(ctx_), 0,
-                                       e.name_get().get());
-      }
-    else
+    if (is_ssa(e))
       {
-        value_ = builder_.CreateAlloca(llvm_type(*e.type_get()), nullptr,
-                                       e.name_get().get());
+        auto init = translate(*e.init_get());
+        // Void var types are actually Ints represented by a 0
+        if (dynamic_cast<const type::Void*>(e.type_get()))
+          init = builder_.getInt32(0);
+        var_write(e, builder_.GetInsertBlock(), init);
+        return;
       }
 
-    locals_[current_function_][&e] = value_;
+    // FIXED: Some code was deleted here.
+    // The escaping variables are in the frame, allocated once for all
+    // in the entry block, even when declared in a loop.
+    value_ =
+      create_alloca(current_function_, var_ltype(e), e.name_get().get());
+
+    function_.locals[&e] = value_;
     builder_.CreateStore(translate(*e.init_get()), value_);
   }
 
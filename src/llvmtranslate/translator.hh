@@ -5,12 +5,17 @@
 
 #pragma once
 
+#include <utility>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
+#include <llvm/IR/ValueHandle.h>
 
 #pragma GCC diagnostic pop
 
@@ -31,11 +36,23 @@ namespace llvmtranslate
     /// Import overloaded operator() methods.
     using super_type::operator();
 
-    Translator(llvm::Module& module, escaped_map_type&& escaped);
+    /// Translate into \a module, lifting the functions as told by
+    /// \a escaped.  If \a gc, the records are allocated in the heap of
+    /// the garbage collector of the runtime.  The target is the 64-bit
+    /// variant of the host if \a target_64, its 32-bit variant otherwise.
+    Translator(llvm::Module& module, escaped_map_type&& escaped,
+               bool gc = false, bool target_64 = false);
 
     /// Run the translation.
     void operator()(const ast::Ast& e) override;
 
+    /// \brief Translate the functions \a bodies only, declaring the
+    /// other functions they use.
+    ///
+    /// The functions are then not internal, so that the partitions of
+    /// a program translated separately can be linked together.
+    void translate_partition(const function_decs_type& bodies);
+
     /// \brief Run this visitor on \a node, and return its translation.
     ///
     /// It is also guaranteed that \a value_ is set to it.
@@ -90,28 +107,127 @@ namespace llvmtranslate
     /// IR builder to simplify building nodes and instructions.
     llvm::IRBuilder<> builder_;
 
-    /// Access for each "variable".
-    /// Since the AST doesn't contain the arguments added
-    /// for the lambda lifting, we need to identify them by their declaration.
-    std::map<const llvm::Function*, std::map<const ast::VarDec*, llvm::Value*>>
-      locals_;
-
-    /// For each loop, the basic block immediately after it.
-    std::map<const ast::WhileExp*, llvm::BasicBlock*> loop_end_;
-
     /// Access every escaped variable for each function.
     escaped_map_type escaped_;
 
     /// The llvm type translator.
     LLVMTypeVisitor type_visitor_;
 
+    /// Whether the program uses the garbage collector.
+    bool gc_;
+
+    /// Whether only a partition of the functions is translated.
+    bool partitioned_ = false;
+
+    /// \brief The translation state of the current function.
+    ///
+    /// It is set aside while translating a nested function, and released
+    /// once the function is translated.  The tables are flat hash maps,
+    /// their keys being pointers.
+    struct function_state
+    {
+      /// Access for each "variable" in memory.
+      /// Since the AST doesn't contain the arguments added
+      /// for the lambda lifting, we need to identify them by their
+      /// declaration.
+      llvm::DenseMap<const ast::VarDec*, llvm::Value*> locals;
+
+      /// For each loop, the basic block immediately after it.
+      llvm::DenseMap<const ast::WhileExp*, llvm::BasicBlock*> loop_end;
+
+      /** \name Direct SSA construction
+       **
+       ** The variables that do not escape are not stored in memory:
+       ** their SSA form is built along the translation, as in "Simple
+       ** and Efficient Construction of Static Single Assignment Form"
+       ** (Braun et al., CC 2013).  The control flow of Tiger being
+       ** structured, the predecessors of a block are known when it is
+       ** filled, except for the heads of the loops, which are sealed
+       ** after their body.
+       ** \{ */
+      /// The value of each variable at the end of each block.  The
+      /// handles follow the trivial phis to their replacement.
+      llvm::DenseMap<std::pair<const ast::VarDec*, const llvm::BasicBlock*>,
+                     llvm::WeakTrackingVH>
+        current_def;
+
+      /// The loop heads not sealed yet, with the phis awaiting their
+      /// operands.
+      llvm::DenseMap<
+        const llvm::BasicBlock*,
+        llvm::SmallVector<std::pair<const ast::VarDec*, llvm::PHINode*>, 4>>
+        incomplete_phis;
+      /// \}
+    };
+
+    /// The state of the function being translated.
+    function_state function_;
+
   private:
+    /// The function of \a e, declared first if needed.
+    llvm::Function* function_get(const ast::FunctionDec& e);
+
     /// Get a LLVM access to a variable, usually to be loaded right after.
+    /// The variable is stored in memory, i.e., not in SSA form.
     llvm::Value* access_var(const ast::Var& e);
 
+    /// \name Direct SSA construction
+    /// \{
+    /// Whether \a var is in SSA form, i.e., does not escape.
+    bool is_ssa(const ast::VarDec& var) const;
+
+    /// The llvm type of the values of \a var.
+    llvm::Type* var_ltype(const ast::VarDec& var);
+
+    /// Define \a var as \a val at the end of \a bb.
+    void var_write(const ast::VarDec& var,
+                   llvm::BasicBlock* bb,
+                   llvm::Value* val);
+
+    /// The value of \a var at the end of \a bb.
+    llvm::Value* var_read(const ast::VarDec& var, llvm::BasicBlock* bb);
+
+    /// The value of \a var in \a bb, which does not define it: that of
+    /// its predecessors, through a phi if they may differ.
+    llvm::Value* var_read_recursive(const ast::VarDec& var,
+                                    llvm::BasicBlock* bb);
+
+    /// A phi without operands for \a var, at the head of \a bb.
+    llvm::PHINode* phi_create(const ast::VarDec& var, llvm::BasicBlock* bb);
+
+    /// Add to \a phi the values of \a var in the predecessors of its
+    /// block, and return it, or its replacement if it is trivial.
+    llvm::Value* phi_operands_add(const ast::VarDec& var, llvm::PHINode* phi);
+
+    /// If \a phi merges a single value, besides itself, replace it with
+    /// this value, and return it.  Otherwise, return \a phi.
+    llvm::Value* phi_trivial_remove(llvm::PHINode* phi);
+
+    /// Complete the phis of the loop head \a bb, all its predecessors
+    /// being known.
+    void block_seal(llvm::BasicBlock* bb);
+    /// \}
+
+    /// Translate the comparison \a e to an i1.
+    llvm::Value* translate_comparison(const ast::OpExp& e);
+
+    /// \brief Branch to \a true_bb if \a e is not null, to \a false_bb
+    /// otherwise.
+    ///
+    /// The comparisons are not extended to i32, and the tests built as
+    /// conditionals, such as the desugared `&' and `|', are translated
+    /// as chains of branches.
+    void translate_condition(const ast::Exp& e,
+                             llvm::BasicBlock* true_bb,
+                             llvm::BasicBlock* false_bb);
+
     /// Call the init_array function that allocates and initialize the array.
     llvm::Value* init_array(llvm::Value* count_val, llvm::Value* init_val);
 
+    /// Allocate a record of type \a struct_ltype, bumping the pointer of
+    /// the runtime's allocation region inline.
+    llvm::Value* record_alloc(llvm::Type* struct_ltype, bool empty);
+
     /// Get a llvm::Type from a type::Type using the type_visitor_.
     llvm::Type* llvm_type(const type::Type& type);
 
@@ -5,7 +5,14 @@
 
 #pragma once
 
+#include <ast/var-dec.hh>
 #include <llvmtranslate/translator.hh>
 
 namespace llvmtranslate
-{} // namespace llvmtranslate
+{
+  inline bool Translator::is_ssa(const ast::VarDec& var) const
+  {
+    return !var.is_escaped();
+  }
+
+} // namespace llvmtranslate
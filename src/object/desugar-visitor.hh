@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <set>
+
 #include <astclone/cloner.hh>
 #include <object/fwd.hh>
 #include <parse/tweast.hh>
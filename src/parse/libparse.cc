@@ -3,6 +3,8 @@
  ** \brief Functions and variables exported by the parse module.
  */
 
+#include <ast/arena.hh>
+#include <astclone/libastclone.hh>
 #include <ast/chunk-interface.hh>
 #include <ast/chunk-list.hh>
 #include <misc/file-library.hh>
@@ -17,6 +19,27 @@
 // Define exported parse functions.
 namespace parse
 {
+  namespace
+  {
+    /// The builtin prelude, parsed once for all.
+    ///
+    /// The tree is built in an arena of its own, and is never modified
+    /// nor released: each compilation gets a clone of it, which is much
+    /// cheaper than scanning and parsing the prelude again.
+    const ast::ChunkList& builtin_prelude()
+    {
+      static const ast::ChunkList* const res = [] {
+        ast::Arena::Scope arena(true);
+        TigerDriver td;
+        auto* chunks = std::get<ast::ChunkList*>(td.parse(td.prelude()));
+        td.error_get().ice_on_error_here();
+        return chunks;
+      }();
+      return *res;
+    }
+
+  } // namespace
+
   // Parse a Tiger file, return the corresponding abstract syntax.
   std::pair<ast::ChunkList*, misc::error> parse(const std::string& prelude,
                                                 const std::string& fname,
@@ -25,6 +48,9 @@ namespace parse
                                                 bool parse_trace_p,
                                                 bool enable_object_extensions_p)
   {
+    // The parsed program is a new generation of the AST.
+    ast::Arena::Scope arena;
+
     // Current directory must be that of the file currently processed.
     library.push_current_directory(misc::path(fname).parent_path());
 
@@ -49,7 +75,7 @@ namespace parse
           {
             ast::ChunkList* prelude_chunks =
               (prelude == "builtin"
-                 ? std::get<ast::ChunkList*>(td.parse(td.prelude()))
+                 ? astclone::clone(builtin_prelude())
                  : td.parse_import(prelude, location()));
             if (prelude_chunks)
               in << prelude_chunks;
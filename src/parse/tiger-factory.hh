@@ -85,6 +85,10 @@ namespace parse
 
   ast::ChunkList* make_ChunkList(const location& location);
 
+  /// Build a ChunkList holding \a chunks, in this order.
+  template <class... T>
+  ast::ChunkList* make_ChunkList(const location& location, T*... chunks);
+
   ast::TypeChunk* make_TypeChunk(const location& location);
 
   ast::TypeDec*
@@ -115,6 +119,10 @@ namespace parse
 
   ast::VarChunk* make_VarChunk(const location& location);
 
+  /// Build a VarChunk holding the single \a vardec, as the parser does
+  /// for `var' declarations.
+  ast::VarChunk* make_VarChunk(const location& location, ast::VarDec* vardec);
+
   ast::VarDec* make_VarDec(const location& location,
                            misc::symbol name,
                            ast::NameTy* type_name,
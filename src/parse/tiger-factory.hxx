@@ -162,6 +162,13 @@ namespace parse
     return new ast::ChunkList(location, {});
   }
 
+  template <class... T>
+  inline ast::ChunkList* make_ChunkList(const location& location,
+                                        T*... chunks)
+  {
+    return new ast::ChunkList(location, {chunks...});
+  }
+
   inline ast::TypeChunk* make_TypeChunk(const location& location)
   {
     return new ast::TypeChunk(location);
@@ -227,6 +234,14 @@ namespace parse
     return new ast::VarChunk(location);
   }
 
+  inline ast::VarChunk* make_VarChunk(const location& location,
+                                      ast::VarDec* vardec)
+  {
+    ast::VarChunk* res = make_VarChunk(location);
+    res->emplace_back(*vardec);
+    return res;
+  }
+
   inline ast::VarDec* make_VarDec(const location& location,
                                   misc::symbol name,
                                   ast::NameTy* type_name,
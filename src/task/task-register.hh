@@ -85,6 +85,9 @@ namespace task
      ** \{ */
     /// Access to the tasks timer.
     const misc::timer& timer_get() const;
+    /// Access to the tasks timer, e.g., to time the steps of the
+    /// running task.
+    misc::timer& timer_get();
     /** \} */
 
     /// Ordered vector of tasks.
@@ -12,4 +12,6 @@ namespace task
 {
   inline const misc::timer& TaskRegister::timer_get() const { return timer_; }
 
+  inline misc::timer& TaskRegister::timer_get() { return timer_; }
+
 } // namespace task.
@@ -5,6 +5,7 @@
 
 #include <iostream>
 
+#include <ast/arena.hh>
 #include <common.hh>
 #include <task/task-register.hh>
 #define DEFINE_TASKS 1
@@ -23,6 +24,10 @@ namespace task::tasks
     TaskRegister::instance().print_task_order(std::cout);
   }
 
-  void time_report() { task_timer.dump_on_destruction(std::cerr); }
+  void time_report()
+  {
+    task_timer.dump_on_destruction(std::cerr);
+    ast::Arena::statistics_dump_on_exit(std::cerr);
+  }
 
 } // namespace task::tasks
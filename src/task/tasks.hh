@@ -18,6 +18,9 @@ namespace task::tasks
   /// List the selected tasks in order.
   TASK_DECLARE("task-selection", "list tasks to be run", tasks_selection, "");
   /// Ask for a time report at the end of the execution.
-  TASK_DECLARE("time-report", "report execution times", time_report, "");
+  TASK_DECLARE("time-report",
+               "report execution times and AST allocations",
+               time_report,
+               "");
 
 } // namespace task::tasks
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <ranges>
+#include <set>
 
 #include <ast/all.hh>
 #include <type/type-checker.hh>
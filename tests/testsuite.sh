@@ -11,6 +11,20 @@ NC='\033[0m'
 counter=0
 passed=0
 
+# Set TC_LLVM_64 to check the 64-bit target, which needs no multilib.
+if [ -n "$TC_LLVM_64" ]; then
+  llvm_flags="--llvm-64"
+  clang_flags="-m64"
+else
+  llvm_flags=""
+  clang_flags="-m32"
+fi
+
+# Set TC_LLVM_JOBS to check the translation in as many partitions.
+if [ -n "$TC_LLVM_JOBS" ]; then
+  llvm_flags="$llvm_flags --llvm-jobs=$TC_LLVM_JOBS"
+fi
+
 check() {
     local file="$1"
 
@@ -27,7 +41,7 @@ check() {
 }
 
 check_clang() {
-  clang "-m32" "-otest" "/tmp/runtime-result.ll" 1> /dev/null 2> /dev/null
+  clang "$clang_flags" "-otest" "/tmp/runtime-result.ll" 1> /dev/null 2> /dev/null
 
   if [ $? -eq 0 ]; then
     echo "${GREEN}✓${NC} compilation successful for $file"
@@ -42,7 +56,7 @@ check_llvm() {
 
     counter=$(($counter + 1))
 
-    "$tc" "--llvm-runtime-display" "--llvm-display" $file 1> "/tmp/runtime-result.ll" 2> /dev/null
+    "$tc" $llvm_flags "--llvm-runtime-display" "--llvm-display" $file 1> "/tmp/runtime-result.ll" 2> /dev/null
 
     if [ $? -eq 0 ]; then
       check_clang